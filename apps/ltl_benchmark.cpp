@@ -0,0 +1,110 @@
+#include "utils/reader.hpp"
+#include "ltl/closure.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+namespace
+{
+
+/// \brief Heap allocations of the whole process, the library included
+std::atomic<size_t> allocations{0};
+
+struct measurement
+{
+    size_t m_allocations{0};
+    std::chrono::microseconds m_construct{0};
+    std::chrono::microseconds m_destroy{0};
+};
+
+/// \param resource: memory of the conversion, NULL -- own arena of the converting
+measurement measure(const ltl::ltl::node_t &formula, std::pmr::memory_resource *resource)
+{
+    measurement result{};
+    const size_t before = allocations;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto algo = ltl::converting::construct(ltl::ltl::node_t{formula}, resource);
+    const auto constructed = std::chrono::steady_clock::now();
+    algo.reset();
+    const auto destroyed = std::chrono::steady_clock::now();
+
+    result.m_allocations = allocations - before;
+    result.m_construct = std::chrono::duration_cast<std::chrono::microseconds>(constructed - start);
+    result.m_destroy = std::chrono::duration_cast<std::chrono::microseconds>(destroyed - constructed);
+    return result;
+}
+
+void print(const std::string &name, const measurement &value)
+{
+    std::cout << "  " << std::left << std::setw(8) << name << std::right
+              << " allocations " << std::setw(10) << value.m_allocations
+              << " construct_us " << std::setw(10) << value.m_construct.count()
+              << " destroy_us " << std::setw(8) << value.m_destroy.count() << "\n";
+}
+
+} // namespace anonymous
+
+void* operator new(const std::size_t size)
+{
+    ++allocations;
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc{};
+}
+
+/// \brief std::pmr resources allocate with the alignment
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    ++allocations;
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void *memory = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align))
+        return memory;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+/// \brief Compare heap allocations of each conversion: every container node and atom allocated
+/// separately (new_delete_resource) against the own arena of the converting.
+/// Formulas are read from the standard input, one per line
+int main()
+{
+    for (std::string line; std::getline(std::cin, line);)
+    {
+        std::istringstream in{line};
+        const auto formula = reader::read_formula(in);
+        if (!formula)
+            continue;
+
+        std::cout << formula->to_string() << "\n";
+        print("heap", measure(formula, std::pmr::new_delete_resource()));
+        print("arena", measure(formula, nullptr));
+    }
+
+    return 0;
+}
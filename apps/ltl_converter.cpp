@@ -1,21 +1,115 @@
 #include "utils/reader.hpp"
 #include "ltl/closure.hpp"
+#include "ltl/composition.hpp"
+#include "ltl/monitor.hpp"
+#include "ltl/shape_cache.hpp"
+#include "ltl/tgba.hpp"
 #include "utils/dot_representation.hpp"
+#include "utils/cpp_representation.hpp"
+#include "utils/hoa_representation.hpp"
+#include "utils/server.hpp"
 
 #include <iostream>
 #include <fstream>
+#include <string_view>
+
+namespace
+{
+
+/// \brief Letter is a bit mask over the propositions (p_i of the first one is the lowest bit).
+/// Each state row lists the next state for the letters 0 .. 2^n - 1
+void print_monitor(const ltl::monitor &monitor)
+{
+    const bool is_safety = monitor.get_fragment() == ltl::monitor::fragment::safety;
+    std::cout << "fragment: " << (is_safety ? "safety" : "co-safety") << "\n";
+
+    std::cout << "propositions:";
+    for (const auto it : monitor.get_propositions())
+        std::cout << " p" << it;
+    std::cout << "\ninitial: " << monitor.get_initial_state() << "\n";
+
+    for (ltl::monitor::state_index_t s = 0; s < monitor.get_states_count(); ++s)
+    {
+        const auto verdict = monitor.get_verdict(s);
+        std::cout << s << (verdict == ltl::monitor::verdict::violated    ? " [violated]"
+                           : verdict == ltl::monitor::verdict::satisfied ? " [satisfied]"
+                                                                         : "") << ":";
+        for (ltl::monitor::letter_t letter = 0; letter < monitor.get_letters_count(); ++letter)
+            std::cout << " " << monitor.step(s, letter);
+        std::cout << "\n";
+    }
+}
+
+} // namespace anonymous
 
 /// \brief Program entrance
 /// Read LTL-formula in Polish notation from standard input
 /// Transform LTL-formula to the automaton and save its dot-representation into the @file_path
 /// Print detailed explanation of the each a_i state into the standard output
+///
+/// `--compose` - convert independent conjuncts (without shared propositions) separately and build their product
+/// `--tgba` - save the merged transition-based generalized Büchi automaton into the @file_path instead
+/// and print it in the HOA format
+/// `--hoa` - print the automaton in the HOA format (state-based acceptance) instead of the states explanation
+/// `--monitor` - print minimized deterministic monitor of a safety/co-safety formula as a flat transition table
+/// `--cache <directory>` - reuse the automaton skeleton of a formula with the same shape (up to the propositions)
+/// saved into the <directory> by the previous runs
+/// `--cpp <name>` - additionally save the automaton as a C++ monitor into the <name>.hpp and its round-trip test
+/// (to be linked with libLtl.so) into the <name>_test.cpp
+/// `--server [socket_path]` - serve conversion requests from standard input (or from the Unix domain socket)
+/// until the end of input, see @server::service for the protocol
 /// \return 0 on success
-int main()
+int main(int argc, char *argv[])
 {
+    if (argc > 1 && std::string_view{argv[1]} == "--server")
+    {
+        server::service service{};
+        if (argc > 2)
+        {
+            if (!service.listen(argv[2]))
+            {
+                std::cerr << "Can't listen on the socket " << argv[2] << "\n";
+                return 1;
+            }
+            return 0;
+        }
+
+        service.run(std::cin, std::cout);
+        return 0;
+    }
+
+    if (argc > 1 && std::string_view{argv[1]} == "--monitor")
+    {
+        std::string diagnostic;
+        const auto monitor = ltl::monitor::construct(reader::read_formula(), &diagnostic);
+        if (!monitor)
+        {
+            std::cerr << diagnostic << "\n";
+            return 1;
+        }
+
+        print_monitor(*monitor);
+        return 0;
+    }
+
     // yes, let it be constant. No time to play with user
     const std::string file_path{"dot.gv"};
 
-    const auto algo = ltl::converting::construct(reader::read_formula());
+    if (argc > 1 && std::string_view{argv[1]} == "--tgba")
+    {
+        const auto automaton = ltl::tgba::construct(*ltl::converting::construct(reader::read_formula()));
+        std::ofstream{file_path} << dot::convert_to_dot(*automaton);
+        std::cout << hoa::convert_to_hoa(*automaton);
+        return 0;
+    }
+
+    const bool compose = argc > 1 && std::string_view{argv[1]} == "--compose";
+    const bool cpp = argc > 2 && std::string_view{argv[1]} == "--cpp";
+    const bool print_hoa = argc > 1 && std::string_view{argv[1]} == "--hoa";
+    const bool cache = argc > 2 && std::string_view{argv[1]} == "--cache";
+    const auto algo = compose ? ltl::composition::construct(reader::read_formula())->materialize()
+                      : cache ? ltl::shape_cache{argv[2]}.convert(reader::read_formula())
+                              : ltl::converting::construct(reader::read_formula());
     const auto [states, dot] = dot::convert_to_dot(algo);
 
     {
@@ -24,6 +118,26 @@ int main()
         out_file << dot;
     }
 
+    if (cpp)
+    {
+        const std::string name{argv[2]};
+        std::string diagnostic;
+        const std::string header = cpp::convert_to_cpp(algo, name, &diagnostic);
+        if (header.empty())
+        {
+            std::cerr << diagnostic << "\n";
+            return 1;
+        }
+        std::ofstream{name + ".hpp"} << header;
+        std::ofstream{name + "_test.cpp"} << cpp::generate_round_trip_test(algo, name, name + ".hpp");
+    }
+
+    if (print_hoa)
+    {
+        std::cout << hoa::convert_to_hoa(algo);
+        return 0;
+    }
+
     // print detailed explanation of the states (atomic plurality for each a_i)
     for (const auto &it : states)
         std::cout << it << "\n";
@@ -0,0 +1,13 @@
+# Generate the C++ monitor of the FORMULA and its round-trip test into OUTPUT_DIR:
+# cmake -DCONVERTER=<ltl_converter> -DFORMULA=<formula> -DOUTPUT_DIR=<dir> -DNAME=<name> -P round_trip.cmake
+file(MAKE_DIRECTORY ${OUTPUT_DIR})
+file(WRITE ${OUTPUT_DIR}/formula.txt "${FORMULA}\n")
+execute_process(
+        COMMAND ${CONVERTER} --cpp ${NAME}
+        INPUT_FILE ${OUTPUT_DIR}/formula.txt
+        WORKING_DIRECTORY ${OUTPUT_DIR}
+        RESULT_VARIABLE result
+        OUTPUT_QUIET)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "ltl_converter --cpp ${NAME} failed: ${result}")
+endif ()
@@ -0,0 +1,107 @@
+#pragma once
+
+/* C interface of libLtl.so.
+ *
+ * Queries of the lists (states, transitions, ...) follow one convention: the function returns the full size of
+ * the list and copies at most @capacity first elements to the caller array. Call it with NULL / 0 to get the size.
+ * Formulas and automata don't depend on the context they were created by and are immutable, so they can be
+ * queried from several threads. Contexts are thread-safe. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct ltl_context ltl_context;
+typedef struct ltl_formula ltl_formula;
+typedef struct ltl_automaton ltl_automaton;
+typedef struct ltl_tgba ltl_tgba;
+
+typedef enum ltl_status
+{
+    LTL_OK = 0,
+    LTL_ERROR_ARGUMENT,
+    /* incorrect LTL-formula or the buffer has something after it */
+    LTL_ERROR_PARSE,
+    /* conversion was stopped by ltl_context_cancel */
+    LTL_ERROR_CANCELLED,
+    LTL_ERROR_MEMORY,
+    /* unexpected failure of the library, e.g. a worker thread couldn't be started */
+    LTL_ERROR_INTERNAL
+} ltl_status;
+
+/* Convert independent conjuncts separately and explore their product. Such conversion can't be cancelled */
+#define LTL_OPTION_COMPOSE 1u
+
+typedef struct ltl_options
+{
+    /* sizeof(ltl_options) of the caller: fields after it have default values */
+    size_t size;
+    /* LTL_OPTION_* bits */
+    uint32_t flags;
+} ltl_options;
+
+const char* ltl_status_string(ltl_status status);
+
+ltl_context* ltl_context_create(void);
+/* All conversions of the context should be finished */
+void ltl_context_destroy(ltl_context *context);
+/* Stop conversions of the context that are running now: they return LTL_ERROR_CANCELLED */
+void ltl_context_cancel(ltl_context *context);
+
+/* Parse the formula in Polish notation (e.g. "U p0 p1") from the @size bytes of the @buffer */
+ltl_status ltl_parse(ltl_context *context, const char *buffer, size_t size, ltl_formula **formula);
+void ltl_formula_destroy(ltl_formula *formula);
+/* Text of the formula, truncated to @capacity - 1 characters and zero-terminated
+ * \return length of the full text */
+size_t ltl_formula_to_string(const ltl_formula *formula, char *buffer, size_t capacity);
+
+/* \param options: NULL -- defaults */
+ltl_status ltl_convert(ltl_context *context, const ltl_formula *formula, const ltl_options *options,
+                       ltl_automaton **automaton);
+void ltl_automaton_destroy(ltl_automaton *automaton);
+
+/* States are the indexes of the atoms: [0, ltl_automaton_atoms_count) */
+size_t ltl_automaton_atoms_count(const ltl_automaton *automaton);
+size_t ltl_automaton_closure_size(const ltl_automaton *automaton);
+/* Text of the closure element, see ltl_formula_to_string */
+size_t ltl_automaton_closure_element(const ltl_automaton *automaton, size_t element, char *buffer, size_t capacity);
+/* signs[i] is 1 if the closure element i is in the atom, 0 if its negation is */
+size_t ltl_automaton_atom(const ltl_automaton *automaton, size_t state, uint8_t *signs, size_t capacity);
+
+/* Atomic propositions of the formula, ascending */
+size_t ltl_automaton_propositions(const ltl_automaton *automaton, uint32_t *propositions, size_t capacity);
+/* Reachable states, ascending */
+size_t ltl_automaton_states(const ltl_automaton *automaton, size_t *states, size_t capacity);
+size_t ltl_automaton_initial_states(const ltl_automaton *automaton, size_t *states, size_t capacity);
+/* Propositions that hold on each transition from the @state */
+size_t ltl_automaton_letter(const ltl_automaton *automaton, size_t state, uint32_t *propositions, size_t capacity);
+size_t ltl_automaton_next_states(const ltl_automaton *automaton, size_t state, size_t *states, size_t capacity);
+/* One final states plurality per eventuality (Until, Finally, Globally, Release or Weak Until) of the closure */
+size_t ltl_automaton_final_sets_count(const ltl_automaton *automaton);
+size_t ltl_automaton_final_states(const ltl_automaton *automaton, size_t set, size_t *states, size_t capacity);
+
+/* Transition-based generalized Büchi automaton with the merged states: acceptance sets are on the edges */
+ltl_status ltl_automaton_to_tgba(const ltl_automaton *automaton, ltl_tgba **tgba);
+void ltl_tgba_destroy(ltl_tgba *tgba);
+
+/* States are [0, ltl_tgba_states_count) */
+size_t ltl_tgba_states_count(const ltl_tgba *tgba);
+size_t ltl_tgba_initial_state(const ltl_tgba *tgba);
+/* One acceptance set per eventuality (Until, Finally, Globally, Release or Weak Until) of the closure */
+size_t ltl_tgba_acceptance_sets_count(const ltl_tgba *tgba);
+/* Edges of the @state are [0, ltl_tgba_edges_count) */
+size_t ltl_tgba_edges_count(const ltl_tgba *tgba, size_t state);
+size_t ltl_tgba_edge_target(const ltl_tgba *tgba, size_t state, size_t edge);
+/* Propositions that hold on the edge, ascending */
+size_t ltl_tgba_edge_letter(const ltl_tgba *tgba, size_t state, size_t edge, uint32_t *propositions,
+                            size_t capacity);
+/* Acceptance sets of the edge, ascending */
+size_t ltl_tgba_edge_marks(const ltl_tgba *tgba, size_t state, size_t edge, size_t *sets, size_t capacity);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
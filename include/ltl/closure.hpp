@@ -2,23 +2,110 @@
 
 #include "ltl/ltl.hpp"
 
-#include <vector>
-#include <set>
+#include <atomic>
+#include <functional>
+#include <future>
 #include <map>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <stop_token>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 namespace ltl
 {
 
+/// \brief All data of the conversion (closure, atoms, automaton and negation nodes of the atoms) is allocated
+/// from one memory resource. By default it's an own monotonic arena: a lot of small allocations are served from
+/// a few contiguous blocks and all of them are released at once with the converting.
+/// \note copies of the containers (e.g. @get_automaton_representation) use the default memory resource
 class converting
 {
 public:
-    using state_t = std::vector<ltl::node_t>;
-    using indexes_container_t = std::set<size_t>;
+    using state_t = std::pmr::vector<ltl::node_t>;
+    using indexes_container_t = std::pmr::set<size_t>;
+    using alphabet_t = std::pmr::set<ltl_atom::index_atom_t>;
     /// \brief key : is an index of At -> value : first -- alph, second -- next states indexes of At
-    using table_t = std::map<size_t, std::pair<std::set<ltl_atom::index_atom_t>, indexes_container_t>>;
+    using table_t = std::pmr::map<size_t, std::pair<alphabet_t, indexes_container_t>>;
+    /// \brief key : is a queue number of eventuality -> value : final states indexes
+    using finals_t = std::pmr::map<size_t, indexes_container_t>;
+
+    enum class phase : uint8_t
+    {
+        closure = 0,
+        atoms,
+        transitions,
+        done
+    };
+
+    /// \brief Snapshot of the running conversion
+    struct progress
+    {
+        phase m_phase{phase::closure};
+        /// \brief Atoms generated
+        size_t m_atoms{0};
+        /// \brief States of the automaton expanded
+        size_t m_states{0};
+        /// \brief States found, but not expanded yet
+        size_t m_frontier{0};
+    };
+    /// \brief Called when a phase starts, every few thousand generated atoms and after each expanded state.
+    /// Calls are serialized: atoms of a large closure are enumerated by the shared worker threads, so they
+    /// may call it instead of the converting thread
+    using progress_callback_t = std::function<void(const progress &)>;
+
+    /// \brief Handle of the conversion running on its own thread.
+    /// Destruction of the handle cancels the conversion and waits for the thread
+    class task
+    {
+    public:
+        /// \brief Request the conversion to stop: @get returns NULL if it hasn't finished yet
+        void cancel();
+        [[nodiscard]]
+        bool is_ready() const;
+        /// \brief Wait for the result. Can be called once. Rethrows the exception of the conversion
+        /// \return automaton, or NULL if the conversion was cancelled
+        std::shared_ptr<converting> get();
 
-    static std::shared_ptr<converting> construct(ltl::node_t&& formula);
+    private:
+        friend class converting;
+
+        std::future<std::shared_ptr<converting>> m_result{};
+        /// \note joined before @m_result is destroyed
+        std::jthread m_thread{};
+    };
+
+    /// \param resource: memory of the conversion, NULL -- own monotonic arena.
+    /// Nodes of the atoms are allocated from it too, so they shouldn't outlive the resource
+    static std::shared_ptr<converting> construct(ltl::node_t&& formula,
+                                                 std::pmr::memory_resource *resource = nullptr);
+    /// \brief Interruptible conversion: @stop is checked for each assignment of the atoms enumeration
+    /// and for each candidate transition
+    /// \return automaton, or NULL if the stop was requested before the conversion finished
+    static std::shared_ptr<converting> construct(ltl::node_t&& formula, std::stop_token stop,
+                                                 const progress_callback_t &callback = {},
+                                                 std::pmr::memory_resource *resource = nullptr);
+    /// \brief Start the conversion on a new thread. @callback is called by that thread
+    static task construct_async(ltl::node_t&& formula, progress_callback_t callback = {},
+                                std::pmr::memory_resource *resource = nullptr);
+
+    /// \brief Replace the converted formula f with (f ^ @conjunct) without the full reconversion:
+    /// closure is extended with the new elements only, each atom is refined with the signs of the new elements
+    /// and transitions/final states are checked against the new elements only.
+    /// \note atom indexes are the same as after the conversion of (f ^ @conjunct) from scratch, if the automaton
+    /// was built by @construct. Automaton of @composition::materialize has its own closure order (component
+    /// closures one after another, constants repeated) and the reachable atoms only: the result recognizes
+    /// the same language, but its atoms and their indexes differ from the conversion from scratch
+    /// \note atoms, signs and the transition table are rebuilt: with the own monotonic arena memory of the
+    /// previous ones is released with the automaton only, so each call grows it. Automata that are conjoined
+    /// many times should be constructed with a resource that reuses memory (e.g. unsynchronized_pool_resource)
+    void conjoin(ltl::node_t&& conjunct);
+    /// \brief Interruptible @conjoin: @stop is checked as in the interruptible @construct
+    /// \return false, if the stop was requested: the automaton has no atoms and states then and should be discarded
+    bool conjoin(ltl::node_t&& conjunct, std::stop_token stop);
 
     [[maybe_unused, nodiscard]]
     ltl::node_t get_ltl_formula() const;
@@ -26,6 +113,8 @@ public:
     [[maybe_unused, nodiscard]]
     const state_t& get_closure() const;
 
+    [[nodiscard]]
+    size_t get_atoms_count() const;
     [[nodiscard]]
     const state_t& get_concrete_state(size_t index) const;
     /// \brief Get data related to the resulted Automaton
@@ -33,65 +122,151 @@ public:
     /// [1] AP - atomic propositions indexes used in LTL-formula
     /// [2] f - transition table of state's index (key) : pair (value) of a alphabet (first) to get state's index (second)
     /// [3] A_0 - atomic plurality indexes that represents Automaton initial states
-    /// [4] F - plurality of a final states pluralities where key is a queue number of Until operator in closer
-    ///                                             with value of an appropriate final state indexes plurality for it
+    /// [4] F - plurality of a final states pluralities where key is a queue number of eventuality (see @is_eventuality)
+    ///                     operator in closer with value of an appropriate final state indexes plurality for it
     /// \return A, AP, f, A_0, F
     [[nodiscard]]
-    std::tuple<indexes_container_t, std::set<ltl_atom::index_atom_t>, table_t, indexes_container_t,
-               std::map<size_t, indexes_container_t>> get_automaton_representation() const;
+    std::tuple<indexes_container_t, alphabet_t, table_t, indexes_container_t, finals_t>
+                get_automaton_representation() const;
 
     constexpr static bool implication(bool a, bool b);
     static bool is_in(const state_t &bunch, const ltl::node_t &node);
+    /// \brief Until and Finally operators need their own final states plurality, so do Globally, Release and
+    /// Weak Until for their negations: !(G a) = F !a, !(a R b) = !a U !b, !(a W b) = !b U (!a ^ !b)
+    static bool is_eventuality(const ltl::node_t &node);
 
 private:
-    explicit converting(ltl::node_t&& formula);
+    friend class composition;
+    friend class shape_cache;
+
+    /// \brief Empty automaton to be filled by @composition
+    converting() = default;
+    converting(ltl::node_t&& formula, std::pmr::memory_resource *resource);
+
+    /// \brief Run all phases of the conversion
+    /// \return false, if it was stopped
+    bool convert(const std::stop_token &stop, const progress_callback_t &callback);
 
-    static bool z1_rule(const state_t &s, const ltl::node_t &node);
+    /// \brief Operand of a closure element: index of its positive form in the closure
+    struct literal_t
+    {
+        size_t m_index{0};
+        bool m_negated{false};
+    };
 
-    static bool r1_rule(const state_t &s, const state_t &sd, const ltl::node_t &node);
-    static bool r2_rule(const state_t &s, const state_t &sd, const ltl::node_t &node);
-    /// rules R1-R2 + modified with neg
-    static bool satisfies_r_rules(const state_t &s, const state_t &sd, const ltl::node_t &node);
+    /// \brief Closure element compiled for the rules, e.g. "closure[i] is U of closure[j] and ! closure[k]"
+    struct record_t
+    {
+        ltl::kind m_kind{ltl::kind::undefined};
+        /// \brief the only operand of the unary operators
+        literal_t m_left{};
+        literal_t m_right{};
+        /// \brief Proposition of the atom
+        ltl_atom::index_atom_t m_proposition{0};
+    };
+
+    /// \brief Sign of each closure element in the atoms: bit i of an atom is set if closure[i] is in it
+    using signs_t = std::pmr::vector<uint64_t>;
+
+    /// \brief Compile the closure elements from @first into @m_rules. Operands always precede the element
+    void compile_rules(size_t first);
+    [[nodiscard]]
+    literal_t to_literal(const ltl::node_t &node) const;
+
+    [[nodiscard]]
+    const uint64_t* get_signs(size_t atom) const;
+    /// \brief Recreate @m_At from @m_signs
+    void store_atoms();
+    /// \brief Recreate @m_signs from @m_At
+    void collect_signs();
+
+    /// \brief Propositions of the atom @s: the letter of its outgoing transitions
+    [[nodiscard]]
+    alphabet_t get_letter(const uint64_t *s) const;
+
+    /// \brief rule Z1 of the eventuality @i
+    [[nodiscard]]
+    bool z1_rule(const uint64_t *s, size_t i) const;
+    /// \brief rules R1-R6 of the temporal operator @i
+    [[nodiscard]]
+    bool satisfies_r_rules(const uint64_t *s, const uint64_t *sd, size_t i) const;
+    /// \brief Atom rules of the element @i: only signs of the elements up to @i are used
+    [[nodiscard]]
+    bool satisfies_atomic_rules(const uint64_t *atomic, size_t i) const;
 
     /// \brief Initial state calculation. Save in @m_A_0_indexes
     /// \param formula: LTL-formula from input
     void detect_initial_states(const ltl::node_t &formula);
 
-    void generate_atomic_plurality();
-    /// \note @pos and @neg size should be equal
-    static void recursive_brute_force(std::vector<state_t> &states, const state_t &pos, const state_t &neg,
-                                      state_t curr = {}, size_t i = 0);
+    /// \brief State of the atoms enumeration shared by the enumerating threads
+    struct enumeration_t
+    {
+        std::stop_token m_stop{};
+        const progress_callback_t *m_callback{nullptr};
+        /// \brief Atoms generated by all threads
+        std::atomic<size_t> m_atoms{0};
+        /// \brief Serializes the calls of @m_callback
+        std::mutex m_mutex{};
+    };
 
-    static bool conjunction_rule(const state_t &atomic, const ltl::node_t &node);
-    static bool until_rules(const state_t &atomic, const ltl::node_t &node);
-    static bool satisfies_atomic_rules(const state_t &atomic, const ltl::node_t &node);
+    /// \return false, if it was stopped
+    bool generate_atomic_plurality(const std::stop_token &stop = {}, const progress_callback_t &callback = {});
+    /// \brief Append to @signs all consistent sign assignments of the closure elements from @i,
+    /// @curr keeps the signs of the previous elements. Subtree is cut as soon as an element breaks its rules
+    void recursive_brute_force(signs_t &signs, signs_t &curr, enumeration_t &enumeration, size_t i) const;
 
     void fill_closure(const ltl::node_t& formula);
     void add_to_closure(const ltl::node_t& formula);
 
     /// \brief Algorithm implementing
-    void ltl_to_nga();
+    /// \return false, if it was stopped
+    bool ltl_to_nga(const std::stop_token &stop = {}, const progress_callback_t &callback = {});
+    /// \brief Reconvert after the closure was extended from @old_closure_size elements.
+    /// \param refinement: range [refinement[i], refinement[i + 1]) of @m_At indexes refine the previous atom i
+    /// \param table: previous transition table
+    /// \param finals: previous final states pluralities
+    /// \return false, if it was stopped
+    bool refine_nga(size_t old_closure_size, const std::vector<size_t> &refinement, const table_t &table,
+                    const finals_t &finals, const std::stop_token &stop = {});
+    /// \brief Forget atoms and states of the stopped conversion
+    void clear_automaton();
+
 
+    /// \brief Own arena, if the memory resource wasn't given. Should be destroyed after all containers
+    std::optional<std::pmr::monotonic_buffer_resource> m_arena{};
+    std::pmr::memory_resource *m_resource{&m_arena.emplace()};
+    /// \brief Automata that own nodes of the atoms (see @composition::materialize)
+    std::vector<std::shared_ptr<const converting>> m_owners{};
 
     /// \brief Store LTL-formula from input
-    const ltl::node_t m_formula;
+    ltl::node_t m_formula{nullptr};
     /// \brief Closure of LTL-formula
-    std::vector<ltl::node_t> m_closure{};
+    state_t m_closure{m_resource};
+    /// \brief Negation of each closure element
+    state_t m_negations{m_resource};
+    /// \brief Rules of each closure element
+    std::pmr::vector<record_t> m_rules{m_resource};
+    /// \brief Indexes of the temporal operators in the closure (rules R1-R6, Z1)
+    std::pmr::vector<size_t> m_temporal{m_resource};
     /// \brief Atomic plurality of LTL-formula
-    std::vector<std::vector<ltl::node_t>> m_At{};
+    std::pmr::vector<state_t> m_At{m_resource};
+    /// \brief Words of the signs per atom
+    size_t m_words{0};
+    /// \brief Signs of the atoms: atom i takes words [i * m_words, (i + 1) * m_words)
+    signs_t m_signs{m_resource};
 
     /// Automaton representation
 
     /// \brief All states in automaton indexes
-    indexes_container_t m_A{};
+    indexes_container_t m_A{m_resource};
     /// \brief All Atomic Propositions in LTL-formula
-    std::set<ltl_atom::index_atom_t> ap{};
+    alphabet_t ap{m_resource};
     /// \brief Transition table via indexes
-    table_t m_table{};
+    table_t m_table{m_resource};
     /// \brief Initial states indexes
-    indexes_container_t m_A_0{};
+    indexes_container_t m_A_0{m_resource};
     /// \brief Final states plurality of pluralities
-    std::map<size_t, indexes_container_t> m_F;
+    finals_t m_F{m_resource};
 };
 
 } // namespace ltl
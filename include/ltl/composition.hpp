@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ltl/closure.hpp"
+
+#include <vector>
+#include <set>
+#include <map>
+
+namespace ltl
+{
+
+/// \brief Compositional translation of a conjunction.
+/// Top-level conjuncts are grouped by the shared atomic propositions, each group is converted separately and the
+/// automaton of the whole formula is their synchronous product. The product is explored lazily (state by state)
+/// or materialized into the ordinary @converting on demand.
+/// \note groups don't share propositions, so they don't share closure elements (except the constant ones)
+/// and the product is the same automaton as the conversion of the whole formula (up to the state numbering)
+class composition
+{
+public:
+    /// \brief Product state: index of the atom in each component
+    using state_t = std::vector<size_t>;
+
+    static std::shared_ptr<composition> construct(ltl::node_t&& formula);
+
+    [[nodiscard]]
+    ltl::node_t get_ltl_formula() const;
+
+    [[nodiscard]]
+    const std::vector<std::shared_ptr<converting>>& get_components() const;
+
+    [[nodiscard]]
+    std::vector<state_t> get_initial_states() const;
+    /// \brief Alphabet to leave the @state
+    [[nodiscard]]
+    converting::alphabet_t get_alphabet(const state_t &state) const;
+    [[nodiscard]]
+    std::vector<state_t> get_next_states(const state_t &state) const;
+
+    /// \brief Number of final states pluralities: component final sets are numbered one after another
+    [[nodiscard]]
+    size_t get_final_sets_count() const;
+    [[nodiscard]]
+    bool is_final(size_t set, const state_t &state) const;
+
+    /// \brief Explore all reachable product states
+    /// \param states: optional, product state of each atom index of the result
+    /// \return automaton where atom of the product is a concatenation of component atoms
+    [[nodiscard]]
+    std::shared_ptr<converting> materialize(std::vector<state_t> *states = nullptr) const;
+
+private:
+    explicit composition(ltl::node_t&& formula);
+
+    /// \brief Split top-level conjunction into the conjuncts
+    static void collect_conjuncts(const ltl::node_t &formula, std::vector<ltl::node_t> &conjuncts);
+    static void collect_propositions(const ltl::node_t &formula, std::set<ltl_atom::index_atom_t> &ap);
+
+    /// \brief Data of the converted component
+    struct component
+    {
+        converting::table_t m_table{};
+        converting::indexes_container_t m_A_0{};
+        converting::finals_t m_F{};
+        /// \brief Number of the first final set of the component in the product
+        size_t m_first_final{0};
+    };
+
+    /// \brief Store LTL-formula from input
+    const ltl::node_t m_formula;
+    std::vector<std::shared_ptr<converting>> m_components{};
+    std::vector<component> m_data{};
+    size_t m_finals_count{0};
+};
+
+} // namespace ltl
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <string>
 
 namespace ltl
@@ -11,6 +12,8 @@ namespace ltl
 class ltl
 {
 public:
+    /// \brief Node and its control block are allocated from the memory resource given to the factory:
+    /// the node shouldn't outlive this resource
     using node_t = std::shared_ptr<ltl>;
 
     enum class kind : uint8_t
@@ -21,14 +24,21 @@ public:
         negation,
         conjunction,
         next,
-        until
+        until,
+        disjunction,
+        finally,
+        globally,
+        release,
+        weak_until
     };
 
     [[nodiscard]] kind get_kind() const { return m_kind; };
 
     friend bool operator== (const node_t& left, const node_t& right);
 
-    [[nodiscard]] virtual std::string to_string() const = 0;
+    [[nodiscard]] std::string to_string() const;
+    /// \brief Append formula in Polish notation to the @out: each node is visited once without temporary strings
+    virtual void write(std::string &out) const = 0;
 
 protected:
     explicit ltl(kind kind);
@@ -41,11 +51,11 @@ class ltl_one : public ltl
 {
 public:
 
-    static node_t construct();
+    static node_t construct(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     friend bool operator== (const std::shared_ptr<ltl_one>& left, const std::shared_ptr<ltl_one>& right);
 
-    [[nodiscard]] std::string to_string() const final;
+    void write(std::string &out) const final;
 
 private:
     explicit ltl_one();
@@ -56,11 +66,12 @@ class ltl_atom : public ltl
 public:
     using index_atom_t = uint32_t;
 
-    static node_t construct(index_atom_t index);
+    static node_t construct(index_atom_t index,
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     friend bool operator== (const std::shared_ptr<ltl_atom>& left, const std::shared_ptr<ltl_atom>& right);
 
-    [[nodiscard]] std::string to_string() const final;
+    void write(std::string &out) const final;
 
     const index_atom_t m_index{0};
 
@@ -72,11 +83,12 @@ class ltl_negation : public ltl
 {
 public:
 
-    static node_t construct(node_t &&formula);
+    static node_t construct(node_t &&formula,
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     friend bool operator== (const std::shared_ptr<ltl_negation>& left, const std::shared_ptr<ltl_negation>& right);
 
-    [[nodiscard]] std::string to_string() const final;
+    void write(std::string &out) const final;
 
     const node_t m_negformula{nullptr};
 
@@ -88,11 +100,12 @@ class ltl_conjunction : public ltl
 {
 public:
 
-    static node_t construct(node_t &&left, node_t &&right);
+    static node_t construct(node_t &&left, node_t &&right,
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     friend bool operator== (const std::shared_ptr<ltl_conjunction>& left, const std::shared_ptr<ltl_conjunction>& right);
 
-    [[nodiscard]] std::string to_string() const final;
+    void write(std::string &out) const final;
 
     const node_t m_left{nullptr};
     const node_t m_right{nullptr};
@@ -105,11 +118,12 @@ class ltl_next : public ltl
 {
 public:
 
-    static node_t construct(node_t &&xformula);
+    static node_t construct(node_t &&xformula,
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     friend bool operator== (const std::shared_ptr<ltl_next>& left, const std::shared_ptr<ltl_next>& right);
 
-    [[nodiscard]] std::string to_string() const final;
+    void write(std::string &out) const final;
 
     const node_t m_xformula{nullptr};
 
@@ -121,11 +135,12 @@ class ltl_until : public ltl
 {
 public:
 
-    static node_t construct(node_t &&left, node_t &&right);
+    static node_t construct(node_t &&left, node_t &&right,
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     friend bool operator== (const std::shared_ptr<ltl_until>& left, const std::shared_ptr<ltl_until>& right);
 
-    [[nodiscard]] std::string to_string() const final;
+    void write(std::string &out) const final;
 
     const node_t m_left{nullptr};
     const node_t m_right{nullptr};
@@ -134,6 +149,94 @@ private:
     explicit ltl_until(node_t left, node_t right);
 };
 
+class ltl_disjunction : public ltl
+{
+public:
+
+    static node_t construct(node_t &&left, node_t &&right,
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    friend bool operator== (const std::shared_ptr<ltl_disjunction>& left, const std::shared_ptr<ltl_disjunction>& right);
+
+    void write(std::string &out) const final;
+
+    const node_t m_left{nullptr};
+    const node_t m_right{nullptr};
+
+private:
+    explicit ltl_disjunction(node_t left, node_t right);
+};
+
+class ltl_finally : public ltl
+{
+public:
+
+    static node_t construct(node_t &&fformula,
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    friend bool operator== (const std::shared_ptr<ltl_finally>& left, const std::shared_ptr<ltl_finally>& right);
+
+    void write(std::string &out) const final;
+
+    const node_t m_fformula{nullptr};
+
+private:
+    explicit ltl_finally(node_t formula);
+};
+
+class ltl_globally : public ltl
+{
+public:
+
+    static node_t construct(node_t &&gformula,
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    friend bool operator== (const std::shared_ptr<ltl_globally>& left, const std::shared_ptr<ltl_globally>& right);
+
+    void write(std::string &out) const final;
+
+    const node_t m_gformula{nullptr};
+
+private:
+    explicit ltl_globally(node_t formula);
+};
+
+class ltl_release : public ltl
+{
+public:
+
+    static node_t construct(node_t &&left, node_t &&right,
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    friend bool operator== (const std::shared_ptr<ltl_release>& left, const std::shared_ptr<ltl_release>& right);
+
+    void write(std::string &out) const final;
+
+    const node_t m_left{nullptr};
+    const node_t m_right{nullptr};
+
+private:
+    explicit ltl_release(node_t left, node_t right);
+};
+
+class ltl_weak_until : public ltl
+{
+public:
+
+    static node_t construct(node_t &&left, node_t &&right,
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    friend bool operator== (const std::shared_ptr<ltl_weak_until>& left, const std::shared_ptr<ltl_weak_until>& right);
+
+    void write(std::string &out) const final;
+
+    const node_t m_left{nullptr};
+    const node_t m_right{nullptr};
+
+private:
+    explicit ltl_weak_until(node_t left, node_t right);
+};
+
 bool operator== (const ltl::node_t& left, const ltl::node_t& right);
 
 } // namespace ltl
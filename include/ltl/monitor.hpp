@@ -0,0 +1,96 @@
+#pragma once
+
+#include "ltl/closure.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ltl
+{
+
+/// \brief Minimized deterministic monitor of a safety or co-safety LTL-formula.
+/// Alphabet is dense: letter bit j is set when proposition get_propositions()[j] holds,
+/// so one event costs a single lookup in the flat transition table.
+class monitor
+{
+public:
+    enum class fragment : uint8_t
+    {
+        undefined = 0,
+        /// \brief negation normal form uses ^, |, X, G, R, W only: violation is detected by a finite prefix
+        safety,
+        /// \brief negation normal form uses ^, |, X, F, U only: satisfaction is detected by a finite prefix
+        co_safety
+    };
+
+    enum class verdict : uint8_t
+    {
+        inconclusive = 0,
+        violated,
+        satisfied
+    };
+
+    using letter_t = uint32_t;
+    using state_index_t = uint32_t;
+
+    /// \brief Limit of the dense alphabet size 2^propositions
+    constexpr static size_t max_propositions = 16;
+
+    /// \param diagnostic: optional, explanation why the monitor can't be built
+    /// \return monitor, or NULL if formula is outside of the safety and co-safety fragments
+    static std::shared_ptr<monitor> construct(ltl::node_t&& formula, std::string *diagnostic = nullptr);
+
+    /// \brief Syntactic detection. Formulas in both fragments (e.g. without temporal operators) are safety
+    static fragment detect_fragment(const ltl::node_t &formula);
+
+    [[nodiscard]]
+    fragment get_fragment() const;
+
+    /// \brief Atomic propositions in the letter bits order (ascending)
+    [[nodiscard]]
+    const std::vector<ltl_atom::index_atom_t>& get_propositions() const;
+
+    [[nodiscard]]
+    size_t get_states_count() const;
+    [[nodiscard]]
+    size_t get_letters_count() const;
+    [[nodiscard]]
+    state_index_t get_initial_state() const;
+
+    [[nodiscard]]
+    state_index_t step(state_index_t state, letter_t letter) const
+    {
+        return m_table[static_cast<size_t>(state) * m_letters_count + letter];
+    }
+
+    [[nodiscard]]
+    verdict get_verdict(state_index_t state) const;
+
+    /// \brief Flat transition table: next state is [state * letters count + letter]
+    [[nodiscard]]
+    const std::vector<state_index_t>& get_table() const;
+
+private:
+    monitor() = default;
+
+    static bool is_in_fragment(const ltl::node_t &formula, bool negated, fragment fragment);
+
+    /// \brief States of @algo with an infinite accepting continuation (they reach accepting cycle)
+    static std::vector<bool> find_live_states(const converting &algo);
+
+    /// \brief Subset construction over the transition table of the NGA. Empty subset is a sink state
+    void determinize(const converting &algo);
+
+    /// \brief Partition refinement: merge states with equal verdicts and equal classes of the next states
+    void minimize();
+
+    fragment m_fragment{fragment::undefined};
+    std::vector<ltl_atom::index_atom_t> m_propositions{};
+    size_t m_letters_count{0};
+    state_index_t m_initial{0};
+    std::vector<verdict> m_verdicts{};
+    std::vector<state_index_t> m_table{};
+};
+
+} // namespace ltl
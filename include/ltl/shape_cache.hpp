@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ltl/closure.hpp"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ltl
+{
+
+/// \brief Conversions of the formulas with the same shape: formulas that differ in the atomic propositions only
+/// (e.g. `U p0 p1` and `U p3 p7`) have the same atoms and transitions up to the letters.
+/// Shape is the closure compiled into the rules without the propositions: atoms, transitions, initial and final
+/// states depend on it only. The automaton skeleton of a shape is converted once and kept in memory (and on disk,
+/// if the directory is given), new formulas of the shape relabel it with their own closure and propositions.
+/// Memory keeps the recently used skeletons only: the least recently used one is evicted over the capacity.
+/// \note thread-safe: concurrent misses of the same shape are converted by each caller, the first one is kept
+class shape_cache
+{
+public:
+    struct statistics
+    {
+        size_t m_memory_hits{0};
+        /// \brief Skeletons loaded from the directory
+        size_t m_disk_hits{0};
+        size_t m_misses{0};
+    };
+
+    /// \param directory: skeletons are saved there and loaded from it on a memory miss, empty -- memory only
+    /// \param capacity: skeletons kept in memory
+    explicit shape_cache(std::string directory = {}, size_t capacity = 1024);
+
+    /// \brief The same automaton as @converting::construct, relabeled from the cached skeleton if possible
+    std::shared_ptr<converting> convert(ltl::node_t&& formula, std::pmr::memory_resource *resource = nullptr);
+
+    [[nodiscard]]
+    statistics get_statistics() const;
+
+private:
+    /// \brief Automaton of the shape without the closure nodes and the letters
+    struct skeleton
+    {
+        size_t m_words{0};
+        std::vector<uint64_t> m_signs{};
+        std::vector<size_t> m_states{};
+        std::vector<size_t> m_initial{};
+        /// \brief state -> next states
+        std::vector<std::pair<size_t, std::vector<size_t>>> m_transitions{};
+        /// \brief queue number of eventuality -> final states
+        std::vector<std::pair<size_t, std::vector<size_t>>> m_finals{};
+    };
+
+    using lru_t = std::list<std::pair<std::string, std::shared_ptr<const skeleton>>>;
+
+    /// \brief Rules of the closure elements and the literal of the formula, propositions are dropped
+    [[nodiscard]]
+    static std::string get_signature(const converting &algo);
+
+    static skeleton extract(const converting &algo);
+    /// \param value: skeleton of the @algo shape, so it has the same words of the signs
+    static void instantiate(converting &algo, const skeleton &value);
+
+    std::shared_ptr<const skeleton> find(const std::string &signature);
+    void insert(const std::string &signature, std::shared_ptr<const skeleton> value);
+
+    /// \param algo: automaton of the shape with the compiled rules: the file has to match its words of the signs,
+    /// eventualities and atomic rules
+    /// \return NULL if the shape wasn't saved or its file is damaged
+    [[nodiscard]]
+    std::shared_ptr<const skeleton> load(const std::string &signature, const converting &algo) const;
+    void save(const std::string &signature, const skeleton &value) const;
+    [[nodiscard]]
+    std::string get_path(const std::string &signature) const;
+
+    const std::string m_directory;
+    const size_t m_capacity;
+
+    /// \brief Recently used skeletons: most recent one is at the front
+    mutable std::mutex m_mutex;
+    lru_t m_lru{};
+    std::unordered_map<std::string, lru_t::iterator> m_skeletons{};
+
+    std::atomic<size_t> m_memory_hits{0};
+    std::atomic<size_t> m_disk_hits{0};
+    std::atomic<size_t> m_misses{0};
+};
+
+} // namespace ltl
@@ -0,0 +1,672 @@
+#pragma once
+
+#include "ltl/ltl.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// \brief Header-only front end that performs the whole LTL to NGA conversion during compilation.
+/// Formulas are written as types (e.g. `conjunction<atom<0>, negation<until<atom<0>, atom<1>>>>`) and
+/// `automaton<Formula>` exposes closure, atoms and transition table as `constexpr` arrays that follow exactly
+/// the same rules (and therefore the same atom numbering) as @ltl::converting.
+/// No library, parsing or heap allocation is needed at runtime.
+namespace ltl::compile_time
+{
+
+using kind = ltl::kind;
+using index_atom_t = ltl_atom::index_atom_t;
+/// \brief Sign assignment of closure elements: bit i is set when closure[i] is positive in the atom
+using mask_t = uint32_t;
+/// \brief Plurality of atom indexes
+using word_t = uint64_t;
+
+/// \brief Bound of a closure: enumeration of the atoms is performed by the compiler over 2^size assignments
+constexpr size_t max_closure_size = 16;
+/// \brief Bound of a formula syntax tree (before the closure deduplication)
+constexpr size_t max_tree_size = 64;
+
+/// \brief Reference to a closure element or to its negation
+struct literal
+{
+    size_t m_index{0};
+    bool m_negated{false};
+
+    friend constexpr bool operator== (const literal &left, const literal &right) = default;
+};
+
+/// \brief Element of a closure. Negation is never an element: it is a sign of the @literal
+struct element
+{
+    kind m_kind{kind::undefined};
+    index_atom_t m_index{0};
+    literal m_left{};
+    literal m_right{};
+};
+
+struct closure_t
+{
+    std::array<element, max_closure_size> m_elements{};
+    size_t m_size{0};
+};
+
+namespace detail
+{
+
+/// \brief Syntax tree node, mirrors an @ltl::ltl object after its factory simplifications
+struct tree_node
+{
+    kind m_kind{kind::undefined};
+    index_atom_t m_index{0};
+    size_t m_left{0};
+    size_t m_right{0};
+};
+
+struct tree_t
+{
+    std::array<tree_node, max_tree_size> m_nodes{};
+    size_t m_size{0};
+
+    constexpr size_t add(const tree_node &node)
+    {
+        if (m_size == max_tree_size)
+            throw "formula is too big for the compile time conversion";
+        m_nodes[m_size] = node;
+        return m_size++;
+    }
+};
+
+/// \brief Structural equality, the same as @ltl::operator== for nodes
+constexpr bool equal(const tree_t &tree, const size_t left, const size_t right)
+{
+    const tree_node &l = tree.m_nodes[left];
+    const tree_node &r = tree.m_nodes[right];
+    if (l.m_kind != r.m_kind)
+        return false;
+
+    switch (l.m_kind)
+    {
+        case kind::one:
+            return true;
+        case kind::atom:
+            return l.m_index == r.m_index;
+        case kind::negation:
+        case kind::next:
+        case kind::finally:
+        case kind::globally:
+            return equal(tree, l.m_left, r.m_left);
+        case kind::conjunction:
+        case kind::disjunction:
+            return (equal(tree, l.m_left, r.m_left) && equal(tree, l.m_right, r.m_right)) ||
+                   (equal(tree, l.m_left, r.m_right) && equal(tree, l.m_right, r.m_left));
+        case kind::until:
+        case kind::release:
+        case kind::weak_until:
+            return equal(tree, l.m_left, r.m_left) && equal(tree, l.m_right, r.m_right);
+        default:
+            throw "incorrect proposition during comparing";
+    }
+}
+
+constexpr size_t make_negation(tree_t &tree, const size_t formula)
+{
+    // optimization block with negative child
+    if (tree.m_nodes[formula].m_kind == kind::negation)
+        return tree.m_nodes[formula].m_left;
+
+    return tree.add({kind::negation, 0, formula, 0});
+}
+
+constexpr bool is_false(const tree_t &tree, const size_t index)
+{
+    const tree_node &node = tree.m_nodes[index];
+    return node.m_kind == kind::negation && tree.m_nodes[node.m_left].m_kind == kind::one;
+}
+
+constexpr size_t make_conjunction(tree_t &tree, const size_t left, const size_t right)
+{
+    // optimization block with true/false child
+    if (tree.m_nodes[left].m_kind == kind::one)
+        return right;
+    if (tree.m_nodes[right].m_kind == kind::one)
+        return left;
+    if (is_false(tree, left) || is_false(tree, right))
+        return make_negation(tree, tree.add({kind::one}));
+    // optimization block with equal children
+    if (equal(tree, left, right))
+        return left;
+
+    return tree.add({kind::conjunction, 0, left, right});
+}
+
+constexpr size_t make_disjunction(tree_t &tree, const size_t left, const size_t right)
+{
+    // optimization block with true/false child
+    if (tree.m_nodes[left].m_kind == kind::one || tree.m_nodes[right].m_kind == kind::one)
+        return tree.add({kind::one});
+    if (is_false(tree, left))
+        return right;
+    if (is_false(tree, right))
+        return left;
+    // optimization block with equal children
+    if (equal(tree, left, right))
+        return left;
+
+    return tree.add({kind::disjunction, 0, left, right});
+}
+
+constexpr bool equal(const element &left, const element &right)
+{
+    if (left.m_kind != right.m_kind)
+        return false;
+
+    switch (left.m_kind)
+    {
+        case kind::one:
+            return true;
+        case kind::atom:
+            return left.m_index == right.m_index;
+        case kind::next:
+        case kind::finally:
+        case kind::globally:
+            return left.m_left == right.m_left;
+        case kind::conjunction:
+        case kind::disjunction:
+            return (left.m_left == right.m_left && left.m_right == right.m_right) ||
+                   (left.m_left == right.m_right && left.m_right == right.m_left);
+        case kind::until:
+        case kind::release:
+        case kind::weak_until:
+            return left.m_left == right.m_left && left.m_right == right.m_right;
+        default:
+            throw "incorrect closure element";
+    }
+}
+
+/// \brief The same as @ltl::converting::add_to_closure
+constexpr literal add_to_closure(closure_t &closure, const element &formula)
+{
+    for (size_t i = 0; i < closure.m_size; ++i)
+        if (equal(closure.m_elements[i], formula))
+            return {i, false};
+
+    if (closure.m_size == max_closure_size)
+        throw "closure is too big for the compile time conversion";
+    closure.m_elements[closure.m_size] = formula;
+    return {closure.m_size++, false};
+}
+
+/// \brief The same as @ltl::converting::fill_closure
+/// \return reference to the closure element that represents @node
+constexpr literal fill_closure(closure_t &closure, const tree_t &tree, const size_t node)
+{
+    const tree_node &formula = tree.m_nodes[node];
+    switch (formula.m_kind)
+    {
+        case kind::negation:
+        {
+            literal inner = fill_closure(closure, tree, formula.m_left);
+            inner.m_negated = !inner.m_negated;
+            return inner;
+        }
+        case kind::one:
+        case kind::atom:
+            return add_to_closure(closure, {formula.m_kind, formula.m_index});
+        case kind::next:
+        case kind::finally:
+        case kind::globally:
+            return add_to_closure(closure, {formula.m_kind, 0, fill_closure(closure, tree, formula.m_left)});
+        case kind::conjunction:
+        case kind::until:
+        case kind::disjunction:
+        case kind::release:
+        case kind::weak_until:
+        {
+            const literal left = fill_closure(closure, tree, formula.m_left);
+            const literal right = fill_closure(closure, tree, formula.m_right);
+            return add_to_closure(closure, {formula.m_kind, 0, left, right});
+        }
+        default:
+            throw "Shouldn't happen - we must cover all cases";
+    }
+}
+
+constexpr bool is_positive(const mask_t atom, const size_t index)
+{
+    return (atom >> index) & 1u;
+}
+
+constexpr bool is_in(const mask_t atom, const literal &lit)
+{
+    return is_positive(atom, lit.m_index) != lit.m_negated;
+}
+
+constexpr bool implication(const bool a, const bool b)
+{
+    return !a || b;
+}
+
+/// \brief Rules of the atomic plurality, the same as @ltl::converting::satisfies_atomic_rules
+constexpr bool satisfies_atomic_rules(const closure_t &closure, const mask_t atom)
+{
+    for (size_t i = 0; i < closure.m_size; ++i)
+    {
+        const element &node = closure.m_elements[i];
+        const bool is_node_in_atomic = is_positive(atom, i);
+        const bool is_a_in_atomic = is_in(atom, node.m_left);
+        const bool is_b_in_atomic = is_in(atom, node.m_right);
+
+        bool rule = true;
+        switch (node.m_kind)
+        {
+            case kind::one:
+                rule = is_node_in_atomic;
+                break;
+            case kind::conjunction:
+                rule = is_node_in_atomic == (is_a_in_atomic && is_b_in_atomic);
+                break;
+            case kind::disjunction:
+                rule = is_node_in_atomic == (is_a_in_atomic || is_b_in_atomic);
+                break;
+            case kind::until:
+            case kind::weak_until:
+                rule = implication(is_node_in_atomic && !is_b_in_atomic, is_a_in_atomic) &&
+                       implication(is_b_in_atomic, is_node_in_atomic);
+                break;
+            case kind::finally:
+                rule = implication(is_a_in_atomic, is_node_in_atomic);
+                break;
+            case kind::globally:
+                rule = implication(is_node_in_atomic, is_a_in_atomic);
+                break;
+            case kind::release:
+                rule = implication(is_node_in_atomic, is_b_in_atomic) &&
+                       implication(is_a_in_atomic && is_b_in_atomic, is_node_in_atomic);
+                break;
+            default:
+                break;
+        }
+        if (!rule)
+            return false;
+    }
+
+    return true;
+}
+
+/// \brief Rules R1-R6 between state @s and the next state @sd
+constexpr bool satisfies_r_rules(const closure_t &closure, const mask_t s, const mask_t sd)
+{
+    for (size_t i = 0; i < closure.m_size; ++i)
+    {
+        const element &node = closure.m_elements[i];
+        const bool is_node_in_s = is_positive(s, i);
+        const bool is_a_in_s = is_in(s, node.m_left);
+        const bool is_b_in_s = is_in(s, node.m_right);
+        const bool is_node_s_in_sd = is_positive(sd, i);
+
+        bool rule = is_node_in_s;
+        switch (node.m_kind)
+        {
+            case kind::next:
+                rule = is_in(sd, node.m_left);
+                break;
+            case kind::until:
+            case kind::weak_until:
+                rule = is_b_in_s || (is_a_in_s && is_node_s_in_sd);
+                break;
+            case kind::finally:
+                rule = is_a_in_s || is_node_s_in_sd;
+                break;
+            case kind::globally:
+                rule = is_a_in_s && is_node_s_in_sd;
+                break;
+            case kind::release:
+                rule = is_b_in_s && (is_a_in_s || is_node_s_in_sd);
+                break;
+            default:
+                break;
+        }
+        if (is_node_in_s != rule)
+            return false;
+    }
+
+    return true;
+}
+
+/// \brief Converts an atom number in the order of @ltl::converting::recursive_brute_force
+/// (closure[0] is the most significant, positive sign goes first) to its sign assignment
+constexpr mask_t to_mask(const closure_t &closure, const mask_t number)
+{
+    mask_t mask = 0;
+    for (size_t i = 0; i < closure.m_size; ++i)
+        if (!is_positive(number, closure.m_size - 1 - i))
+            mask |= mask_t{1} << i;
+
+    return mask;
+}
+
+constexpr size_t count_atoms(const closure_t &closure)
+{
+    size_t count = 0;
+    for (mask_t number = 0; number < (mask_t{1} << closure.m_size); ++number)
+        if (satisfies_atomic_rules(closure, to_mask(closure, number)))
+            ++count;
+
+    return count;
+}
+
+template<size_t N>
+constexpr std::array<mask_t, N> make_atoms(const closure_t &closure)
+{
+    std::array<mask_t, N> atoms{};
+    size_t count = 0;
+    for (mask_t number = 0; number < (mask_t{1} << closure.m_size); ++number)
+        if (const mask_t atom = to_mask(closure, number); satisfies_atomic_rules(closure, atom))
+            atoms[count++] = atom;
+
+    return atoms;
+}
+
+constexpr bool is_atom(const kind kind)
+{
+    return kind == kind::atom;
+}
+
+/// \brief Until and Finally operators need their own final states plurality, so do the negated Globally,
+/// Release and Weak Until (see @ltl::converting::is_eventuality)
+constexpr bool is_eventuality(const kind kind)
+{
+    return kind == kind::until || kind == kind::finally || kind == kind::globally || kind == kind::release ||
+           kind == kind::weak_until;
+}
+
+/// \brief Rule Z1 of the eventuality closure[@i] in the state @s
+constexpr bool z1_rule(const closure_t &closure, const mask_t s, const size_t i)
+{
+    const element &node = closure.m_elements[i];
+    const bool is_node_in_s = is_positive(s, i);
+    const bool is_a_in_s = is_in(s, node.m_left);
+    const bool is_b_in_s = is_in(s, node.m_right);
+
+    switch (node.m_kind)
+    {
+        case kind::until:
+            return implication(is_node_in_s, is_b_in_s);
+        case kind::finally:
+            return implication(is_node_in_s, is_a_in_s);
+        case kind::globally:
+            return implication(!is_node_in_s, !is_a_in_s);
+        case kind::release:
+            return implication(!is_node_in_s, !is_b_in_s);
+        case kind::weak_until:
+            return implication(!is_node_in_s, !is_a_in_s && !is_b_in_s);
+        default:
+            return false;
+    }
+}
+
+constexpr size_t count_of(const closure_t &closure, bool (*predicate)(kind))
+{
+    size_t count = 0;
+    for (size_t i = 0; i < closure.m_size; ++i)
+        if (predicate(closure.m_elements[i].m_kind))
+            ++count;
+
+    return count;
+}
+
+template<size_t N>
+constexpr std::array<size_t, N> indexes_of(const closure_t &closure, bool (*predicate)(kind))
+{
+    std::array<size_t, N> indexes{};
+    size_t count = 0;
+    for (size_t i = 0; i < closure.m_size; ++i)
+        if (predicate(closure.m_elements[i].m_kind))
+            indexes[count++] = i;
+
+    return indexes;
+}
+
+template<size_t W>
+constexpr bool contains(const std::array<word_t, W> &set, const size_t index)
+{
+    return (set[index / 64] >> (index % 64)) & 1u;
+}
+
+template<size_t W>
+constexpr void insert(std::array<word_t, W> &set, const size_t index)
+{
+    set[index / 64] |= word_t{1} << (index % 64);
+}
+
+} // namespace detail
+
+/// \brief Constant true
+struct one
+{
+    static constexpr size_t make(detail::tree_t &tree) { return tree.add({kind::one}); }
+};
+
+/// \brief Proposition p<N>
+template<index_atom_t N>
+struct atom
+{
+    static constexpr size_t make(detail::tree_t &tree) { return tree.add({kind::atom, N}); }
+};
+
+template<typename F>
+struct negation
+{
+    static constexpr size_t make(detail::tree_t &tree) { return detail::make_negation(tree, F::make(tree)); }
+};
+
+template<typename L, typename R>
+struct conjunction
+{
+    static constexpr size_t make(detail::tree_t &tree)
+    {
+        const size_t left = L::make(tree);
+        return detail::make_conjunction(tree, left, R::make(tree));
+    }
+};
+
+template<typename F>
+struct next
+{
+    static constexpr size_t make(detail::tree_t &tree) { return tree.add({kind::next, 0, F::make(tree)}); }
+};
+
+template<typename L, typename R>
+struct until
+{
+    static constexpr size_t make(detail::tree_t &tree)
+    {
+        const size_t left = L::make(tree);
+        return tree.add({kind::until, 0, left, R::make(tree)});
+    }
+};
+
+template<typename L, typename R>
+struct disjunction
+{
+    static constexpr size_t make(detail::tree_t &tree)
+    {
+        const size_t left = L::make(tree);
+        return detail::make_disjunction(tree, left, R::make(tree));
+    }
+};
+
+template<typename F>
+struct finally
+{
+    static constexpr size_t make(detail::tree_t &tree) { return tree.add({kind::finally, 0, F::make(tree)}); }
+};
+
+template<typename F>
+struct globally
+{
+    static constexpr size_t make(detail::tree_t &tree) { return tree.add({kind::globally, 0, F::make(tree)}); }
+};
+
+template<typename L, typename R>
+struct release
+{
+    static constexpr size_t make(detail::tree_t &tree)
+    {
+        const size_t left = L::make(tree);
+        return tree.add({kind::release, 0, left, R::make(tree)});
+    }
+};
+
+template<typename L, typename R>
+struct weak_until
+{
+    static constexpr size_t make(detail::tree_t &tree)
+    {
+        const size_t left = L::make(tree);
+        return tree.add({kind::weak_until, 0, left, R::make(tree)});
+    }
+};
+
+/// \brief NGA of the @Formula. Atom indexes are the same as in @ltl::converting for the equivalent formula.
+/// Pluralities of atoms are bit sets (@state_set_t) where bit i stands for the atom a<i>.
+template<typename Formula>
+class automaton
+{
+    struct root_t
+    {
+        closure_t m_closure{};
+        literal m_formula{};
+    };
+
+    static constexpr root_t make_root()
+    {
+        detail::tree_t tree{};
+        const size_t formula = Formula::make(tree);
+
+        root_t root{};
+        root.m_formula = detail::fill_closure(root.m_closure, tree, formula);
+        return root;
+    }
+
+    static constexpr root_t s_root = make_root();
+
+public:
+    /// \brief Closure of LTL-formula
+    static constexpr closure_t closure = s_root.m_closure;
+    /// \brief Reference of the LTL-formula in its closure
+    static constexpr literal formula = s_root.m_formula;
+
+    /// \brief Atomic plurality of LTL-formula: sign assignment of the closure for each atom
+    static constexpr size_t atoms_count = detail::count_atoms(closure);
+    static constexpr std::array<mask_t, atoms_count> atoms = detail::make_atoms<atoms_count>(closure);
+
+    static constexpr size_t words_count = atoms_count / 64 + 1;
+    using state_set_t = std::array<word_t, words_count>;
+
+    /// \brief All Atomic Propositions in LTL-formula (ascending)
+    static constexpr size_t propositions_count = detail::count_of(closure, detail::is_atom);
+    static constexpr std::array<index_atom_t, propositions_count> propositions = []
+    {
+        auto indexes = detail::indexes_of<propositions_count>(closure, detail::is_atom);
+        std::array<index_atom_t, propositions_count> result{};
+        for (size_t i = 0; i < propositions_count; ++i)
+            result[i] = closure.m_elements[indexes[i]].m_index;
+        for (size_t i = 0; i < propositions_count; ++i)
+            for (size_t j = i + 1; j < propositions_count; ++j)
+                if (result[j] < result[i])
+                {
+                    const index_atom_t tmp = result[i];
+                    result[i] = result[j];
+                    result[j] = tmp;
+                }
+        return result;
+    }();
+
+    /// \brief Alphabet of the transitions from each atom: bit j stands for propositions[j]
+    static constexpr std::array<uint64_t, atoms_count> letters = []
+    {
+        std::array<uint64_t, atoms_count> result{};
+        for (size_t s = 0; s < atoms_count; ++s)
+            for (size_t i = 0; i < closure.m_size; ++i)
+                if (closure.m_elements[i].m_kind == kind::atom && detail::is_positive(atoms[s], i))
+                    for (size_t j = 0; j < propositions_count; ++j)
+                        if (propositions[j] == closure.m_elements[i].m_index)
+                            result[s] |= uint64_t{1} << j;
+        return result;
+    }();
+
+    /// \brief Initial states
+    static constexpr state_set_t initial = []
+    {
+        state_set_t result{};
+        for (size_t s = 0; s < atoms_count; ++s)
+            if (detail::is_in(atoms[s], formula))
+                detail::insert(result, s);
+        return result;
+    }();
+
+    /// \brief Transition table: next states of the each atom (empty for the unreachable ones)
+    static constexpr std::array<state_set_t, atoms_count> transitions = []
+    {
+        std::array<state_set_t, atoms_count> result{};
+        state_set_t visited = initial;
+        for (bool changed = true; changed;)
+        {
+            changed = false;
+            for (size_t s = 0; s < atoms_count; ++s)
+            {
+                if (!detail::contains(visited, s) || result[s] != state_set_t{})
+                    continue;
+                for (size_t sd = 0; sd < atoms_count; ++sd)
+                {
+                    if (!detail::satisfies_r_rules(closure, atoms[s], atoms[sd]))
+                        continue;
+                    detail::insert(result[s], sd);
+                    if (!detail::contains(visited, sd))
+                    {
+                        detail::insert(visited, sd);
+                        changed = true;
+                    }
+                }
+            }
+        }
+        return result;
+    }();
+
+    /// \brief All reachable states in automaton
+    static constexpr state_set_t states = []
+    {
+        state_set_t result = initial;
+        for (size_t s = 0; s < atoms_count; ++s)
+            for (size_t w = 0; w < words_count; ++w)
+                result[w] |= transitions[s][w];
+        return result;
+    }();
+
+    /// \brief Final states pluralities, one per eventuality in closure order (rule Z1)
+    static constexpr size_t finals_count = detail::count_of(closure, detail::is_eventuality);
+    static constexpr std::array<state_set_t, finals_count> finals = []
+    {
+        const auto eventualities = detail::indexes_of<finals_count>(closure, detail::is_eventuality);
+        std::array<state_set_t, finals_count> result{};
+        for (size_t k = 0; k < finals_count; ++k)
+            for (size_t s = 0; s < atoms_count; ++s)
+                if (detail::contains(states, s) && detail::z1_rule(closure, atoms[s], eventualities[k]))
+                    detail::insert(result[k], s);
+        return result;
+    }();
+
+    [[nodiscard]] static constexpr bool is_initial(const size_t index) { return detail::contains(initial, index); }
+    [[nodiscard]] static constexpr bool is_state(const size_t index) { return detail::contains(states, index); }
+    [[nodiscard]] static constexpr bool is_transition(const size_t from, const size_t to)
+    {
+        return detail::contains(transitions[from], to);
+    }
+    [[nodiscard]] static constexpr bool is_final(const size_t set, const size_t index)
+    {
+        return detail::contains(finals[set], index);
+    }
+};
+
+} // namespace ltl::compile_time
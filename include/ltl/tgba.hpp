@@ -0,0 +1,74 @@
+#pragma once
+
+#include "ltl/closure.hpp"
+
+#include <compare>
+#include <cstdint>
+#include <vector>
+
+namespace ltl
+{
+
+/// \brief Transition-based generalized Büchi automaton of the converted formula.
+/// State is a position between two letters: the edge into an atom reads the letter of the atom and carries
+/// the eventualities it satisfies (rule Z1). Outgoing edges of an atom depend on its successors only,
+/// so atoms with the same future are merged.
+class tgba
+{
+public:
+    using state_index_t = uint32_t;
+
+    struct edge
+    {
+        /// \brief Propositions that hold, the other propositions of the formula don't
+        std::vector<ltl_atom::index_atom_t> m_letter{};
+        /// \brief Acceptance sets of the edge: queue numbers of the eventualities
+        std::vector<size_t> m_marks{};
+        state_index_t m_target{0};
+
+        friend auto operator<=> (const edge &left, const edge &right) = default;
+    };
+
+    static std::shared_ptr<tgba> construct(const converting &algo);
+
+    [[nodiscard]]
+    ltl::node_t get_ltl_formula() const;
+
+    /// \brief Atomic propositions, ascending
+    [[nodiscard]]
+    const std::vector<ltl_atom::index_atom_t>& get_propositions() const;
+
+    [[nodiscard]]
+    size_t get_states_count() const;
+    [[nodiscard]]
+    state_index_t get_initial_state() const;
+
+    /// \brief One acceptance set per eventuality (see @converting::is_eventuality) of the closure
+    [[nodiscard]]
+    size_t get_acceptance_sets_count() const;
+
+    [[nodiscard]]
+    const std::vector<edge>& get_edges(state_index_t state) const;
+
+private:
+    tgba() = default;
+
+    /// \brief Edge while merging: index of its label (letter and marks) in the high half, target in the low one
+    using packed_edge_t = uint64_t;
+
+    /// \brief State 0 is the initial one (before the first letter), atom i is the state i + 1
+    /// \param labels: distinct (letter, marks) of the edges, their targets are unused
+    void translate(const converting &algo, std::vector<edge> &labels,
+                   std::vector<std::vector<packed_edge_t>> &edges);
+
+    /// \brief Partition refinement: merge states with equal outgoing edges up to the classes of the targets
+    void merge(const std::vector<edge> &labels, const std::vector<std::vector<packed_edge_t>> &edges);
+
+    ltl::node_t m_formula{nullptr};
+    std::vector<ltl_atom::index_atom_t> m_propositions{};
+    size_t m_acceptance_sets_count{0};
+    state_index_t m_initial{0};
+    std::vector<std::vector<edge>> m_edges{};
+};
+
+} // namespace ltl
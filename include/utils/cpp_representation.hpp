@@ -0,0 +1,26 @@
+#pragma once
+
+#include "ltl/closure.hpp"
+
+#include <string>
+
+namespace cpp
+{
+
+/// \brief Generate a self-contained C++ header with the automaton implemented as a monitor:
+/// `<name>::state_set` type, `<name>::monitor::step(valuation)` with unrolled transitions and tracking of the
+/// final states pluralities. Generated code doesn't depend on the library and doesn't use heap.
+/// \param name: namespace of the generated code (C++ identifier)
+/// \param diagnostic: optional, explanation why the monitor can't be generated
+/// \return header content, empty if the formula has 64 or more propositions or eventualities
+std::string convert_to_cpp(const std::shared_ptr<ltl::converting>& algo, const std::string &name,
+                           std::string *diagnostic = nullptr);
+
+/// \brief Generate a test program that checks the monitor from @header against the library automaton
+/// on random traces. It should be linked with libLtl.so
+/// \param header: include path of the @convert_to_cpp output
+/// \return source content, empty if the monitor can't be generated (see @convert_to_cpp)
+std::string generate_round_trip_test(const std::shared_ptr<ltl::converting>& algo, const std::string &name,
+                                     const std::string &header, std::string *diagnostic = nullptr);
+
+} // namespace cpp
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ltl/closure.hpp"
+#include "ltl/tgba.hpp"
 
 namespace dot
 {
@@ -9,4 +10,7 @@ namespace dot
 /// \return first element is a state representation and the second is a dot-language graph
 std::pair<std::vector<std::string>, std::string> convert_to_dot(const std::shared_ptr<ltl::converting>& algo);
 
+/// \return dot-language graph of the transition-based automaton: each edge has its letter and acceptance sets
+std::string convert_to_dot(const ltl::tgba &automaton);
+
 } // namespace dot
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "ltl/closure.hpp"
+#include "ltl/tgba.hpp"
+
+#include <string>
+
+namespace hoa
+{
+
+/// \brief Hanoi Omega-Automata format (HOA v1) with the state-based generalized Büchi acceptance.
+/// Reachable atoms are numbered in the ascending order, each edge reads the letter of its source
+std::string convert_to_hoa(const std::shared_ptr<ltl::converting>& algo);
+
+/// \brief Hanoi Omega-Automata format (HOA v1) with the transition-based generalized Büchi acceptance
+std::string convert_to_hoa(const ltl::tgba &automaton);
+
+} // namespace hoa
@@ -2,6 +2,8 @@
 
 #include "ltl/ltl.hpp"
 
+#include <istream>
+
 namespace reader
 {
 
@@ -9,4 +11,10 @@ namespace reader
 /// \return	the parsed formula, or NULL on error
 std::shared_ptr<ltl::ltl> read_formula();
 
+/// Read an LTL formula from the @in stream. Remaining input is left in the stream
+/// \param resource: memory of the formula nodes
+/// \return	the parsed formula, or NULL on error
+std::shared_ptr<ltl::ltl> read_formula(std::istream &in,
+                                       std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
 } // namespace reader
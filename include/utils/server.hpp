@@ -0,0 +1,100 @@
+#pragma once
+
+#include "ltl/closure.hpp"
+#include "ltl/shape_cache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <list>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace server
+{
+
+/// \brief Long-running conversion service that keeps recent conversions warm in memory.
+///
+/// Request is a single line: `<command> [<LTL-formula>]`
+/// - `dot <formula>` - dot-language graph of the automaton
+/// - `states <formula>` - detailed explanation of each a_i state (one per line)
+/// - `tgba <formula>` - dot-language graph of the merged transition-based automaton
+/// - `hoa <formula>` - the merged transition-based automaton in the HOA format
+/// - `stats` - latency percentiles (microseconds), cache hit rate and shape cache hits
+///
+/// Formulas missing in the cache are converted through the shape cache: a formula that differs from a converted
+/// one in the propositions only relabels its automaton. The transition-based automaton of a cached formula is
+/// built on its first `tgba` or `hoa` request
+///
+/// Request is at most 64 KiB and has nothing after the formula.
+/// Response is framed by its size: `ok <bytes>\n<payload>` or `error <bytes>\n<message>`.
+/// A request that fails (e.g. runs out of memory) gets an error, the server and its cache stay intact
+class service
+{
+public:
+    /// \param max_connections: connections served by @listen at once, the next ones are refused
+    explicit service(size_t cache_capacity = 1024, size_t max_connections = 64);
+
+    /// \brief Handle a single request line. Thread-safe
+    /// \return framed response
+    std::string handle(const std::string &request);
+
+    /// \brief Serve requests line by line from @in until the end of stream
+    void run(std::istream &in, std::ostream &out);
+
+    /// \brief Listen on the Unix domain @socket_path, each connection is served by its own thread
+    /// \return false if socket can't be created or accepting the connections failed
+    bool listen(const std::string &socket_path);
+
+    [[nodiscard]] std::string get_statistics() const;
+
+private:
+    struct entry
+    {
+        std::shared_ptr<ltl::converting> m_algo{nullptr};
+        std::string m_dot{};
+        std::string m_states{};
+        /// \brief Transition-based automaton is built by the first `tgba` or `hoa` request of the formula
+        mutable std::once_flag m_tgba_once{};
+        mutable std::string m_tgba_dot{};
+        mutable std::string m_hoa{};
+    };
+
+    using lru_t = std::list<std::pair<std::string, std::shared_ptr<const entry>>>;
+
+    /// \return (payload, success)
+    std::pair<std::string, bool> execute(const std::string &request);
+
+    std::shared_ptr<const entry> find(const std::string &key);
+    void insert(const std::string &key, std::shared_ptr<const entry> value);
+
+    void record_latency(std::chrono::microseconds latency);
+
+    void serve_connection(int fd);
+
+    const size_t m_cache_capacity;
+    const size_t m_max_connections;
+    std::atomic<size_t> m_connections{0};
+
+    /// \brief Recently converted formulas: most recent one is at the front
+    mutable std::mutex m_cache_mutex;
+    lru_t m_lru{};
+    std::unordered_map<std::string, lru_t::iterator> m_cache{};
+    /// \brief Keeps as many shapes as the formulas cache
+    ltl::shape_cache m_shapes;
+
+    std::atomic<size_t> m_hits{0};
+    std::atomic<size_t> m_misses{0};
+
+    /// \brief Ring buffer of the last request latencies
+    mutable std::mutex m_latency_mutex;
+    std::vector<std::chrono::microseconds> m_latencies{};
+    size_t m_latencies_next{0};
+    size_t m_requests{0};
+};
+
+} // namespace server
@@ -0,0 +1,387 @@
+#include "ltl/c_api.h"
+#include "ltl/closure.hpp"
+#include "ltl/composition.hpp"
+#include "ltl/tgba.hpp"
+#include "utils/reader.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stop_token>
+#include <vector>
+
+struct ltl_context
+{
+    std::mutex m_mutex{};
+    /// \brief Source of the running conversions, it's replaced by a new one on cancel
+    std::stop_source m_stop{};
+};
+
+struct ltl_formula
+{
+    ltl::ltl::node_t m_node{nullptr};
+};
+
+/// \brief Automaton representation is copied to the plain containers once, so queries don't allocate
+struct ltl_automaton
+{
+    std::shared_ptr<ltl::converting> m_algo{};
+    std::vector<uint32_t> m_propositions{};
+    std::vector<size_t> m_states{};
+    std::vector<size_t> m_initial{};
+    /// \brief key : atom index -> first -- letter, second -- next states
+    std::map<size_t, std::pair<std::vector<uint32_t>, std::vector<size_t>>> m_table{};
+    std::vector<std::vector<size_t>> m_finals{};
+};
+
+struct ltl_tgba
+{
+    std::shared_ptr<ltl::tgba> m_automaton{};
+};
+
+namespace
+{
+
+/// \return nullptr if there is no such edge
+const ltl::tgba::edge* find_edge(const ltl_tgba *tgba, const size_t state, const size_t edge)
+{
+    if (!tgba || state >= tgba->m_automaton->get_states_count())
+        return nullptr;
+
+    const auto &edges = tgba->m_automaton->get_edges(static_cast<ltl::tgba::state_index_t>(state));
+    return edge < edges.size() ? &edges[edge] : nullptr;
+}
+
+/// \brief Copy at most @capacity first @values to the caller array
+/// \return size of the @values
+template<typename T, typename Container>
+size_t copy_out(const Container &values, T *out, const size_t capacity)
+{
+    if (out)
+        std::copy_n(values.begin(), std::min(capacity, values.size()), out);
+    return values.size();
+}
+
+size_t copy_string(const std::string &text, char *buffer, const size_t capacity)
+{
+    if (buffer && capacity > 0)
+    {
+        const size_t size = std::min(capacity - 1, text.size());
+        std::copy_n(text.begin(), size, buffer);
+        buffer[size] = '\0';
+    }
+    return text.size();
+}
+
+bool has_flag(const ltl_options *options, const uint32_t flag)
+{
+    return options && options->size >= offsetof(ltl_options, flags) + sizeof(options->flags) &&
+           (options->flags & flag) != 0;
+}
+
+void fill_representation(ltl_automaton &automaton)
+{
+    const auto [states, ap, table, initials, finals] = automaton.m_algo->get_automaton_representation();
+    automaton.m_propositions.assign(ap.begin(), ap.end());
+    automaton.m_states.assign(states.begin(), states.end());
+    automaton.m_initial.assign(initials.begin(), initials.end());
+    for (const auto &[state, transition] : table)
+    {
+        automaton.m_table.emplace(state, std::make_pair(
+                std::vector<uint32_t>(transition.first.begin(), transition.first.end()),
+                std::vector<size_t>(transition.second.begin(), transition.second.end())));
+    }
+
+    const auto &closure = automaton.m_algo->get_closure();
+    automaton.m_finals.resize(static_cast<size_t>(std::count_if(closure.begin(), closure.end(),
+                                                                ltl::converting::is_eventuality)));
+    for (const auto &[set, value] : finals)
+        automaton.m_finals[set].assign(value.begin(), value.end());
+}
+
+} // namespace anonymous
+
+extern "C"
+{
+
+const char* ltl_status_string(const ltl_status status)
+{
+    switch (status)
+    {
+        case LTL_OK:
+            return "ok";
+        case LTL_ERROR_ARGUMENT:
+            return "invalid argument";
+        case LTL_ERROR_PARSE:
+            return "incorrect LTL-formula";
+        case LTL_ERROR_CANCELLED:
+            return "conversion was cancelled";
+        case LTL_ERROR_MEMORY:
+            return "out of memory";
+        case LTL_ERROR_INTERNAL:
+            return "internal error";
+    }
+
+    return "unknown status";
+}
+
+ltl_context* ltl_context_create(void)
+{
+    return new (std::nothrow) ltl_context{};
+}
+
+void ltl_context_destroy(ltl_context *context)
+{
+    delete context;
+}
+
+void ltl_context_cancel(ltl_context *context)
+{
+    if (!context)
+        return;
+
+    std::lock_guard lock{context->m_mutex};
+    context->m_stop.request_stop();
+    context->m_stop = std::stop_source{};
+}
+
+ltl_status ltl_parse(ltl_context *context, const char *buffer, const size_t size, ltl_formula **formula)
+{
+    if (!context || !buffer || !formula)
+        return LTL_ERROR_ARGUMENT;
+
+    try
+    {
+        std::istringstream in{std::string{buffer, size}};
+        auto node = reader::read_formula(in);
+        if (!node)
+            return LTL_ERROR_PARSE;
+        // only spaces can follow the formula
+        for (int ch; (ch = in.get()) != std::char_traits<char>::eof();)
+            if (!std::isspace(ch))
+                return LTL_ERROR_PARSE;
+
+        *formula = new ltl_formula{std::move(node)};
+    }
+    catch (const std::bad_alloc &)
+    {
+        return LTL_ERROR_MEMORY;
+    }
+    catch (...)
+    {
+        // exceptions shouldn't cross the C boundary
+        return LTL_ERROR_INTERNAL;
+    }
+
+    return LTL_OK;
+}
+
+void ltl_formula_destroy(ltl_formula *formula)
+{
+    delete formula;
+}
+
+size_t ltl_formula_to_string(const ltl_formula *formula, char *buffer, const size_t capacity)
+{
+    if (!formula)
+        return 0;
+
+    return copy_string(formula->m_node->to_string(), buffer, capacity);
+}
+
+ltl_status ltl_convert(ltl_context *context, const ltl_formula *formula, const ltl_options *options,
+                       ltl_automaton **automaton)
+{
+    if (!context || !formula || !automaton)
+        return LTL_ERROR_ARGUMENT;
+
+    std::stop_token stop;
+    {
+        std::lock_guard lock{context->m_mutex};
+        stop = context->m_stop.get_token();
+    }
+
+    try
+    {
+        auto result = std::make_unique<ltl_automaton>();
+        if (has_flag(options, LTL_OPTION_COMPOSE))
+            result->m_algo = ltl::composition::construct(ltl::ltl::node_t{formula->m_node})->materialize();
+        else
+            result->m_algo = ltl::converting::construct(ltl::ltl::node_t{formula->m_node}, stop);
+        if (!result->m_algo)
+            return LTL_ERROR_CANCELLED;
+
+        fill_representation(*result);
+        *automaton = result.release();
+    }
+    catch (const std::bad_alloc &)
+    {
+        return LTL_ERROR_MEMORY;
+    }
+    catch (...)
+    {
+        return LTL_ERROR_INTERNAL;
+    }
+
+    return LTL_OK;
+}
+
+void ltl_automaton_destroy(ltl_automaton *automaton)
+{
+    delete automaton;
+}
+
+size_t ltl_automaton_atoms_count(const ltl_automaton *automaton)
+{
+    return automaton ? automaton->m_algo->get_atoms_count() : 0;
+}
+
+size_t ltl_automaton_closure_size(const ltl_automaton *automaton)
+{
+    return automaton ? automaton->m_algo->get_closure().size() : 0;
+}
+
+size_t ltl_automaton_closure_element(const ltl_automaton *automaton, const size_t element, char *buffer,
+                                     const size_t capacity)
+{
+    if (!automaton || element >= automaton->m_algo->get_closure().size())
+        return 0;
+
+    return copy_string(automaton->m_algo->get_closure()[element]->to_string(), buffer, capacity);
+}
+
+size_t ltl_automaton_atom(const ltl_automaton *automaton, const size_t state, uint8_t *signs, const size_t capacity)
+{
+    if (!automaton || state >= automaton->m_algo->get_atoms_count())
+        return 0;
+
+    const auto &atom = automaton->m_algo->get_concrete_state(state);
+    if (signs)
+        for (size_t i = 0; i < std::min(capacity, atom.size()); ++i)
+            signs[i] = atom[i]->get_kind() != ltl::ltl::kind::negation;
+    return atom.size();
+}
+
+size_t ltl_automaton_propositions(const ltl_automaton *automaton, uint32_t *propositions, const size_t capacity)
+{
+    return automaton ? copy_out(automaton->m_propositions, propositions, capacity) : 0;
+}
+
+size_t ltl_automaton_states(const ltl_automaton *automaton, size_t *states, const size_t capacity)
+{
+    return automaton ? copy_out(automaton->m_states, states, capacity) : 0;
+}
+
+size_t ltl_automaton_initial_states(const ltl_automaton *automaton, size_t *states, const size_t capacity)
+{
+    return automaton ? copy_out(automaton->m_initial, states, capacity) : 0;
+}
+
+size_t ltl_automaton_letter(const ltl_automaton *automaton, const size_t state, uint32_t *propositions,
+                            const size_t capacity)
+{
+    if (!automaton)
+        return 0;
+
+    const auto it = automaton->m_table.find(state);
+    return it == automaton->m_table.end() ? 0 : copy_out(it->second.first, propositions, capacity);
+}
+
+size_t ltl_automaton_next_states(const ltl_automaton *automaton, const size_t state, size_t *states,
+                                 const size_t capacity)
+{
+    if (!automaton)
+        return 0;
+
+    const auto it = automaton->m_table.find(state);
+    return it == automaton->m_table.end() ? 0 : copy_out(it->second.second, states, capacity);
+}
+
+size_t ltl_automaton_final_sets_count(const ltl_automaton *automaton)
+{
+    return automaton ? automaton->m_finals.size() : 0;
+}
+
+size_t ltl_automaton_final_states(const ltl_automaton *automaton, const size_t set, size_t *states,
+                                  const size_t capacity)
+{
+    if (!automaton || set >= automaton->m_finals.size())
+        return 0;
+
+    return copy_out(automaton->m_finals[set], states, capacity);
+}
+
+ltl_status ltl_automaton_to_tgba(const ltl_automaton *automaton, ltl_tgba **tgba)
+{
+    if (!automaton || !tgba)
+        return LTL_ERROR_ARGUMENT;
+
+    try
+    {
+        *tgba = new ltl_tgba{ltl::tgba::construct(*automaton->m_algo)};
+    }
+    catch (const std::bad_alloc &)
+    {
+        return LTL_ERROR_MEMORY;
+    }
+    catch (...)
+    {
+        return LTL_ERROR_INTERNAL;
+    }
+
+    return LTL_OK;
+}
+
+void ltl_tgba_destroy(ltl_tgba *tgba)
+{
+    delete tgba;
+}
+
+size_t ltl_tgba_states_count(const ltl_tgba *tgba)
+{
+    return tgba ? tgba->m_automaton->get_states_count() : 0;
+}
+
+size_t ltl_tgba_initial_state(const ltl_tgba *tgba)
+{
+    return tgba ? tgba->m_automaton->get_initial_state() : 0;
+}
+
+size_t ltl_tgba_acceptance_sets_count(const ltl_tgba *tgba)
+{
+    return tgba ? tgba->m_automaton->get_acceptance_sets_count() : 0;
+}
+
+size_t ltl_tgba_edges_count(const ltl_tgba *tgba, const size_t state)
+{
+    if (!tgba || state >= tgba->m_automaton->get_states_count())
+        return 0;
+
+    return tgba->m_automaton->get_edges(static_cast<ltl::tgba::state_index_t>(state)).size();
+}
+
+size_t ltl_tgba_edge_target(const ltl_tgba *tgba, const size_t state, const size_t edge)
+{
+    const auto *it = find_edge(tgba, state, edge);
+    return it ? it->m_target : 0;
+}
+
+size_t ltl_tgba_edge_letter(const ltl_tgba *tgba, const size_t state, const size_t edge, uint32_t *propositions,
+                            const size_t capacity)
+{
+    const auto *it = find_edge(tgba, state, edge);
+    return it ? copy_out(it->m_letter, propositions, capacity) : 0;
+}
+
+size_t ltl_tgba_edge_marks(const ltl_tgba *tgba, const size_t state, const size_t edge, size_t *sets,
+                           const size_t capacity)
+{
+    const auto *it = find_edge(tgba, state, edge);
+    return it ? copy_out(it->m_marks, sets, capacity) : 0;
+}
+
+} // extern "C"
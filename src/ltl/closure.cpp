@@ -1,14 +1,212 @@
 #include "ltl/closure.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace ltl
 {
 
-std::shared_ptr<converting> converting::construct(ltl::node_t&& formula)
+namespace
 {
-    return std::shared_ptr<converting>(new converting(std::move(formula)));
+
+/// \brief Closures smaller than this are enumerated by the calling thread only
+constexpr size_t parallel_closure_size = 16;
+/// \brief Tasks per worker: the more tasks, the better the load balance of the unequal subtrees
+constexpr size_t tasks_per_worker = 8;
+/// \brief Progress of the atoms enumeration is reported each time this number of atoms is generated
+constexpr size_t atoms_per_report = 4096;
+
+/// \brief Threads shared by all conversions of the process: hardware_concurrency() - 1 of them.
+/// Concurrent conversions (server connections, C interface contexts) queue their jobs instead of starting
+/// their own threads, so the number of threads doesn't grow with the number of conversions
+class worker_pool
+{
+public:
+    static worker_pool &instance()
+    {
+        static worker_pool pool{std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1};
+        return pool;
+    }
+
+    /// \brief Run @fn(task) for each task in [0, @tasks): the calling thread takes part, idle workers of the pool
+    /// help. Idle threads take the next not started task, so the expensive tasks don't block the cheap ones.
+    /// \note the first exception of @fn is rethrown to the caller, the tasks that weren't started are skipped
+    void run(const size_t tasks, const std::function<void(size_t)> &fn)
+    {
+        const auto current = std::make_shared<job>(fn, tasks);
+        if (!m_threads.empty())
+        {
+            std::lock_guard lock{m_mutex};
+            m_jobs.push_back(current);
+        }
+        m_ready.notify_all();
+
+        execute(*current);
+        {
+            std::unique_lock lock{m_mutex};
+            std::erase(m_jobs, current);
+            m_finished.wait(lock, [&current]() -> bool { return current->m_done == current->m_tasks; });
+        }
+
+        if (current->m_error)
+            std::rethrow_exception(current->m_error);
+    }
+
+private:
+    struct job
+    {
+        job(const std::function<void(size_t)> &fn, const size_t tasks)
+                : m_fn(fn), m_tasks(tasks)
+        {}
+
+        const std::function<void(size_t)> &m_fn;
+        const size_t m_tasks;
+        std::atomic<size_t> m_next{0};
+        /// \brief Guarded by @m_mutex of the pool
+        size_t m_done{0};
+        std::exception_ptr m_error{nullptr};
+    };
+
+    explicit worker_pool(const size_t threads)
+    {
+        m_threads.reserve(threads);
+        for (size_t i = 0; i < threads; ++i)
+            m_threads.emplace_back([this](const std::stop_token stop) { work(stop); });
+    }
+
+    void work(const std::stop_token &stop)
+    {
+        while (true)
+        {
+            std::shared_ptr<job> current{nullptr};
+            {
+                std::unique_lock lock{m_mutex};
+                if (!m_ready.wait(lock, stop, [this]() -> bool { return !m_jobs.empty(); }))
+                    return;
+                current = m_jobs.front();
+                // all tasks of the job are taken: the next idle thread takes the next job
+                if (current->m_next >= current->m_tasks)
+                {
+                    m_jobs.pop_front();
+                    continue;
+                }
+            }
+
+            execute(*current);
+        }
+    }
+
+    void execute(job &current)
+    {
+        size_t done = 0;
+        for (size_t task; (task = current.m_next.fetch_add(1, std::memory_order_relaxed)) < current.m_tasks;)
+        {
+            try
+            {
+                current.m_fn(task);
+            }
+            catch (...)
+            {
+                std::lock_guard lock{m_mutex};
+                if (!current.m_error)
+                    current.m_error = std::current_exception();
+                // skip the tasks that weren't started: they are done
+                const size_t next = current.m_next.exchange(current.m_tasks);
+                done += next < current.m_tasks ? current.m_tasks - next : 0;
+            }
+            ++done;
+        }
+
+        std::lock_guard lock{m_mutex};
+        current.m_done += done;
+        if (current.m_done == current.m_tasks)
+            m_finished.notify_all();
+    }
+
+    std::mutex m_mutex{};
+    std::condition_variable_any m_ready{};
+    std::condition_variable_any m_finished{};
+    /// \brief Jobs that may have not started tasks, the oldest one is at the front
+    std::deque<std::shared_ptr<job>> m_jobs{};
+    /// \note the last member: threads are stopped and joined before the queue is destroyed
+    std::vector<std::jthread> m_threads{};
+};
+
+bool test(const uint64_t *signs, const size_t i)
+{
+    return (signs[i / 64] >> (i % 64)) & 1;
+}
+
+/// \brief see @converting::is_eventuality
+bool is_eventuality_kind(const ltl::kind kind)
+{
+    return kind == ltl::kind::until || kind == ltl::kind::finally || kind == ltl::kind::globally ||
+           kind == ltl::kind::release || kind == ltl::kind::weak_until;
+}
+
+} // namespace anonymous
+
+std::shared_ptr<converting> converting::construct(ltl::node_t&& formula, std::pmr::memory_resource *resource)
+{
+    return construct(std::move(formula), std::stop_token{}, {}, resource);
+}
+
+std::shared_ptr<converting> converting::construct(ltl::node_t&& formula, const std::stop_token stop,
+                                                  const progress_callback_t &callback,
+                                                  std::pmr::memory_resource *resource)
+{
+    auto result = std::shared_ptr<converting>(new converting(std::move(formula), resource));
+    if (!result->convert(stop, callback))
+        return nullptr;
+
+    return result;
+}
+
+converting::task converting::construct_async(ltl::node_t&& formula, progress_callback_t callback,
+                                             std::pmr::memory_resource *resource)
+{
+    std::promise<std::shared_ptr<converting>> promise{};
+    task result{};
+    result.m_result = promise.get_future();
+    result.m_thread = std::jthread{[formula = std::move(formula), callback = std::move(callback), resource,
+                                    promise = std::move(promise)](const std::stop_token stop) mutable
+                                   {
+                                       // failure of the conversion (or of the callback) is rethrown by @get
+                                       try
+                                       {
+                                           promise.set_value(construct(std::move(formula), stop, callback,
+                                                                       resource));
+                                       }
+                                       catch (...)
+                                       {
+                                           promise.set_exception(std::current_exception());
+                                       }
+                                   }};
+
+    return result;
+}
+
+void converting::task::cancel()
+{
+    m_thread.request_stop();
+}
+
+bool converting::task::is_ready() const
+{
+    return m_result.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+}
+
+std::shared_ptr<converting> converting::task::get()
+{
+    return m_result.get();
 }
 
 ltl::node_t converting::get_ltl_formula() const
@@ -16,19 +214,120 @@ ltl::node_t converting::get_ltl_formula() const
     return m_formula;
 }
 
+void converting::conjoin(ltl::node_t&& conjunct)
+{
+    conjoin(std::move(conjunct), std::stop_token{});
+}
+
+bool converting::conjoin(ltl::node_t&& conjunct, const std::stop_token stop)
+{
+    auto formula = ltl_conjunction::construct(ltl::node_t{m_formula}, std::move(conjunct));
+    if (!formula || formula == m_formula)
+        return true;
+
+    if (formula->get_kind() != ltl::kind::conjunction ||
+        std::dynamic_pointer_cast<ltl_conjunction>(formula)->m_left.get() != m_formula.get())
+    {
+        // simplified to something else (e.g. constant false): nothing to reuse
+        m_formula = std::move(formula);
+        m_closure.clear();
+        m_negations.clear();
+        m_rules.clear();
+        m_temporal.clear();
+        m_At.clear();
+        m_signs.clear();
+        m_A.clear();
+        ap.clear();
+        m_table.clear();
+        m_F.clear();
+
+        fill_closure(m_formula);
+        compile_rules(0);
+        if (!generate_atomic_plurality(stop))
+        {
+            clear_automaton();
+            return false;
+        }
+        detect_initial_states(m_formula);
+
+        if (!ltl_to_nga(stop))
+        {
+            clear_automaton();
+            return false;
+        }
+        return true;
+    }
+
+    m_formula = std::move(formula);
+
+    const size_t old_closure_size = m_closure.size();
+    const size_t old_words = m_words;
+    fill_closure(m_formula);
+    compile_rules(old_closure_size);
+
+    const signs_t old_signs = std::move(m_signs);
+    m_signs.clear();
+    std::vector<size_t> refinement{};
+    refinement.reserve(m_At.size() + 1);
+    signs_t curr(m_words, 0, m_resource);
+    enumeration_t enumeration{stop};
+    for (auto it = old_signs.begin(); it != old_signs.end(); it += static_cast<std::ptrdiff_t>(old_words))
+    {
+        refinement.push_back(m_signs.size() / m_words);
+        std::fill(std::copy_n(it, old_words, curr.begin()), curr.end(), 0);
+        recursive_brute_force(m_signs, curr, enumeration, old_closure_size);
+    }
+    if (stop.stop_requested())
+    {
+        clear_automaton();
+        return false;
+    }
+    refinement.push_back(m_signs.size() / m_words);
+    store_atoms();
+
+    detect_initial_states(m_formula);
+
+    const table_t table = std::move(m_table);
+    const finals_t finals = std::move(m_F);
+    m_A.clear();
+    m_table.clear();
+    m_F.clear();
+
+    if (!refine_nga(old_closure_size, refinement, table, finals, stop))
+    {
+        clear_automaton();
+        return false;
+    }
+    return true;
+}
+
+void converting::clear_automaton()
+{
+    m_At.clear();
+    m_signs.clear();
+    m_A.clear();
+    m_A_0.clear();
+    m_table.clear();
+    m_F.clear();
+}
+
 const converting::state_t& converting::get_closure() const
 {
     return m_closure;
 }
 
+size_t converting::get_atoms_count() const
+{
+    return m_At.size();
+}
+
 const converting::state_t& converting::get_concrete_state(const size_t index) const
 {
     return m_At[index];
 }
 
-std::tuple<converting::indexes_container_t, std::set<ltl_atom::index_atom_t>, converting::table_t,
-           converting::indexes_container_t, std::map<size_t, converting::indexes_container_t>>
-                converting::get_automaton_representation() const
+std::tuple<converting::indexes_container_t, converting::alphabet_t, converting::table_t,
+           converting::indexes_container_t, converting::finals_t> converting::get_automaton_representation() const
 {
     return std::make_tuple(m_A, ap, m_table, m_A_0, m_F);
 }
@@ -43,182 +342,366 @@ bool converting::is_in(const state_t &bunch, const ltl::node_t &node)
     return std::any_of(bunch.begin(), bunch.end(), [&node](const ltl::node_t &it) -> bool { return it == node; });
 }
 
-converting::converting(ltl::node_t&& formula) : m_formula(formula)
+converting::converting(ltl::node_t&& formula, std::pmr::memory_resource *resource)
+        : m_resource(resource ? resource : &m_arena.emplace()), m_formula(formula)
+{}
+
+bool converting::convert(const std::stop_token &stop, const progress_callback_t &callback)
 {
+    auto report = [&](const phase phase, const size_t states, const size_t frontier)
+    {
+        if (callback)
+            callback(progress{phase, m_At.size(), states, frontier});
+    };
+
+    report(phase::closure, 0, 0);
     fill_closure(m_formula);
-    generate_atomic_plurality();
+    compile_rules(0);
+
+    report(phase::atoms, 0, 0);
+    if (!generate_atomic_plurality(stop, callback))
+        return false;
     detect_initial_states(m_formula);
 
-    ltl_to_nga();
+    report(phase::transitions, 0, m_A_0.size());
+    if (!ltl_to_nga(stop, callback))
+        return false;
+
+    report(phase::done, m_A.size(), 0);
+    return true;
 }
 
-bool converting::z1_rule(const state_t &s, const ltl::node_t &node)
+bool converting::is_eventuality(const ltl::node_t &node)
 {
-    if (node->get_kind() != ltl::kind::until)
-        return false;
+    return is_eventuality_kind(node->get_kind());
+}
 
-    const bool is_node_in_s = is_in(s, node);
-    const bool is_b_in_s = is_in(s, std::dynamic_pointer_cast<ltl_until>(node)->m_right);
+void converting::compile_rules(const size_t first)
+{
+    m_words = (m_closure.size() + 63) / 64;
+    for (size_t i = first; i < m_closure.size(); ++i)
+    {
+        const ltl::node_t &node = m_closure[i];
+        m_negations.push_back(ltl_negation::construct(ltl::node_t{node}, m_resource));
 
-    return implication(is_node_in_s, is_b_in_s);
+        record_t &record = m_rules.emplace_back();
+        record.m_kind = node->get_kind();
+        switch (record.m_kind)
+        {
+            case ltl::kind::one:
+                break;
+            case ltl::kind::atom:
+                record.m_proposition = std::dynamic_pointer_cast<ltl_atom>(node)->m_index;
+                break;
+            case ltl::kind::conjunction:
+            {
+                const auto &node_conjunction = std::dynamic_pointer_cast<ltl_conjunction>(node);
+                record.m_left = to_literal(node_conjunction->m_left);
+                record.m_right = to_literal(node_conjunction->m_right);
+                break;
+            }
+            case ltl::kind::next:
+                record.m_left = to_literal(std::dynamic_pointer_cast<ltl_next>(node)->m_xformula);
+                break;
+            case ltl::kind::until:
+            {
+                const auto &node_until = std::dynamic_pointer_cast<ltl_until>(node);
+                record.m_left = to_literal(node_until->m_left);
+                record.m_right = to_literal(node_until->m_right);
+                break;
+            }
+            case ltl::kind::disjunction:
+            {
+                const auto &node_disjunction = std::dynamic_pointer_cast<ltl_disjunction>(node);
+                record.m_left = to_literal(node_disjunction->m_left);
+                record.m_right = to_literal(node_disjunction->m_right);
+                break;
+            }
+            case ltl::kind::finally:
+                record.m_left = to_literal(std::dynamic_pointer_cast<ltl_finally>(node)->m_fformula);
+                break;
+            case ltl::kind::globally:
+                record.m_left = to_literal(std::dynamic_pointer_cast<ltl_globally>(node)->m_gformula);
+                break;
+            case ltl::kind::release:
+            {
+                const auto &node_release = std::dynamic_pointer_cast<ltl_release>(node);
+                record.m_left = to_literal(node_release->m_left);
+                record.m_right = to_literal(node_release->m_right);
+                break;
+            }
+            case ltl::kind::weak_until:
+            {
+                const auto &node_weak_until = std::dynamic_pointer_cast<ltl_weak_until>(node);
+                record.m_left = to_literal(node_weak_until->m_left);
+                record.m_right = to_literal(node_weak_until->m_right);
+                break;
+            }
+            default:
+                assert(!"Shouldn't happen - we must cover all cases");
+                break;
+        }
+
+        if (record.m_kind == ltl::kind::next || record.m_kind == ltl::kind::until ||
+            record.m_kind == ltl::kind::finally || record.m_kind == ltl::kind::globally ||
+            record.m_kind == ltl::kind::release || record.m_kind == ltl::kind::weak_until)
+        {
+            m_temporal.push_back(i);
+        }
+    }
 }
 
-bool converting::r1_rule(const state_t &s, const state_t &sd, const ltl::node_t &node)
+converting::literal_t converting::to_literal(const ltl::node_t &node) const
 {
-    if (node->get_kind() != ltl::kind::next)
-        return true;
-
-    // whether negation
-    const bool is_node_in_s = is_in(s, node);;
+    const bool negated = node->get_kind() == ltl::kind::negation;
+    const ltl::node_t &positive = negated ? std::dynamic_pointer_cast<ltl_negation>(node)->m_negformula : node;
 
-    // is a in sd
-    const bool is_a_in_sd = is_in(sd, std::dynamic_pointer_cast<ltl_next>(node)->m_xformula);
+    const auto it = std::find_if(m_closure.begin(), m_closure.end(),
+                                 [&positive](const ltl::node_t &element) -> bool { return element == positive; });
+    assert(it != m_closure.end() && "Subformula should be in the closure");
 
-    return is_node_in_s == is_a_in_sd;
+    return literal_t{static_cast<size_t>(std::distance(m_closure.begin(), it)), negated};
 }
 
-bool converting::r2_rule(const state_t &s, const state_t &sd, const ltl::node_t &node)
+const uint64_t* converting::get_signs(const size_t atom) const
 {
-    if (node->get_kind() != ltl::kind::until)
-        return true;
-
-    // whether negation
-    const bool is_node_in_s = is_in(s, node);
+    return m_signs.data() + atom * m_words;
+}
 
-    const auto &node_s_until = std::dynamic_pointer_cast<ltl_until>(node);
+void converting::store_atoms()
+{
+    const size_t count = m_words == 0 ? 0 : m_signs.size() / m_words;
+    m_At.clear();
+    m_At.reserve(count);
+    for (size_t index = 0; index < count; ++index)
+    {
+        const uint64_t *signs = get_signs(index);
+        state_t &atom = m_At.emplace_back();
+        atom.reserve(m_closure.size());
+        for (size_t i = 0; i < m_closure.size(); ++i)
+            atom.push_back(test(signs, i) ? m_closure[i] : m_negations[i]);
+    }
+}
 
-    const bool is_b_in_s = is_in(s, node_s_until->m_right);
-    const bool is_a_in_s = is_in(s, node_s_until->m_left);
-    const bool is_node_s_in_sd = is_in(sd, node_s_until);
+void converting::collect_signs()
+{
+    m_signs.assign(m_At.size() * m_words, 0);
+    for (size_t index = 0; index < m_At.size(); ++index)
+        for (size_t i = 0; i < m_At[index].size(); ++i)
+            if (m_At[index][i]->get_kind() != ltl::kind::negation)
+                m_signs[index * m_words + i / 64] |= uint64_t{1} << (i % 64);
+}
 
-    const bool rule = is_b_in_s || (is_a_in_s && is_node_s_in_sd);
+converting::alphabet_t converting::get_letter(const uint64_t *s) const
+{
+    // collect all atomic propositions that become curves
+    alphabet_t letter{m_resource};
+    for (size_t alpha = 0; alpha < m_rules.size(); ++alpha)
+        if (m_rules[alpha].m_kind == ltl::kind::atom && test(s, alpha))
+            letter.insert(m_rules[alpha].m_proposition);
 
-    return is_node_in_s == rule;
+    return letter;
 }
 
-bool converting::satisfies_r_rules(const state_t &s, const state_t &sd, const ltl::node_t &node)
+bool converting::z1_rule(const uint64_t *s, const size_t i) const
 {
-    if (const auto kind = node->get_kind(); kind == ltl::kind::negation)
+    const record_t &record = m_rules[i];
+    if (!is_eventuality_kind(record.m_kind))
+        return false;
+
+    const bool is_node_in_s = test(s, i);
+    const bool is_a_in_s = test(s, record.m_left.m_index) != record.m_left.m_negated;
+    const bool is_b_in_s = test(s, record.m_right.m_index) != record.m_right.m_negated;
+
+    switch (record.m_kind)
     {
-        return satisfies_r_rules(s, sd, std::dynamic_pointer_cast<ltl_negation>(node)->m_negformula);
+        case ltl::kind::until:
+            /// (a U b) in s -> b in s
+            return implication(is_node_in_s, is_b_in_s);
+        case ltl::kind::finally:
+            /// (F a) in s -> a in s
+            return implication(is_node_in_s, is_a_in_s);
+        case ltl::kind::globally:
+            /// !(G a) in s -> !a in s
+            return implication(!is_node_in_s, !is_a_in_s);
+        case ltl::kind::release:
+            /// !(a R b) in s -> !b in s
+            return implication(!is_node_in_s, !is_b_in_s);
+        case ltl::kind::weak_until:
+            /// !(a W b) in s -> !a in s AND !b in s
+            return implication(!is_node_in_s, !is_a_in_s && !is_b_in_s);
+        default:
+            return false;
     }
-    else if (kind == ltl::kind::next)
+}
+
+bool converting::satisfies_r_rules(const uint64_t *s, const uint64_t *sd, const size_t i) const
+{
+    const record_t &record = m_rules[i];
+    // whether negation
+    const bool is_node_in_s = test(s, i);
+    const bool is_node_in_sd = test(sd, i);
+    const bool is_a_in_s = test(s, record.m_left.m_index) != record.m_left.m_negated;
+    const bool is_b_in_s = test(s, record.m_right.m_index) != record.m_right.m_negated;
+
+    switch (record.m_kind)
     {
-        /// rule R1: Xa in s = a in sd
-        return r1_rule(s, sd, node);
+        case ltl::kind::next:
+            /// rule R1: Xa in s = a in sd
+            return is_node_in_s == (test(sd, record.m_left.m_index) != record.m_left.m_negated);
+        case ltl::kind::until:
+            /// rule R2: (a U b) in s = b in s OR (a in s AND (a U b) in sd)
+            return is_node_in_s == (is_b_in_s || (is_a_in_s && is_node_in_sd));
+        case ltl::kind::finally:
+            /// rule R3: (F a) in s = a in s OR (F a) in sd
+            return is_node_in_s == (is_a_in_s || is_node_in_sd);
+        case ltl::kind::globally:
+            /// rule R4: (G a) in s = a in s AND (G a) in sd
+            return is_node_in_s == (is_a_in_s && is_node_in_sd);
+        case ltl::kind::release:
+            /// rule R5: (a R b) in s = b in s AND (a in s OR (a R b) in sd)
+            return is_node_in_s == (is_b_in_s && (is_a_in_s || is_node_in_sd));
+        case ltl::kind::weak_until:
+            /// rule R6: (a W b) in s = b in s OR (a in s AND (a W b) in sd)
+            return is_node_in_s == (is_b_in_s || (is_a_in_s && is_node_in_sd));
+        default:
+            return true;
     }
-    else if (kind == ltl::kind::until)
+}
+
+bool converting::satisfies_atomic_rules(const uint64_t *atomic, const size_t i) const
+{
+    const record_t &record = m_rules[i];
+    /// \note this gives us an understanding of whether there was a negation before the node
+    const bool is_node_in_atomic = test(atomic, i);
+    const bool is_a_in_atomic = test(atomic, record.m_left.m_index) != record.m_left.m_negated;
+    const bool is_b_in_atomic = test(atomic, record.m_right.m_index) != record.m_right.m_negated;
+
+    switch (record.m_kind)
     {
-        /// rule R2: (a U b) in s = b in s OR (a in s AND (a U b) in sd)
-        return r2_rule(s, sd, node);
+        case ltl::kind::one:
+            /// rule 1: constant true is in each atom
+            return is_node_in_atomic;
+        case ltl::kind::conjunction:
+            /// rule 2
+            return is_node_in_atomic == (is_a_in_atomic && is_b_in_atomic);
+        case ltl::kind::disjunction:
+            return is_node_in_atomic == (is_a_in_atomic || is_b_in_atomic);
+        case ltl::kind::until:
+            /// rule 3-4
+            return implication(is_node_in_atomic && !is_b_in_atomic, is_a_in_atomic) &&
+                   implication(is_b_in_atomic, is_node_in_atomic);
+        case ltl::kind::finally:
+            return implication(is_a_in_atomic, is_node_in_atomic);
+        case ltl::kind::globally:
+            return implication(is_node_in_atomic, is_a_in_atomic);
+        case ltl::kind::release:
+            return implication(is_node_in_atomic, is_b_in_atomic) &&
+                   implication(is_a_in_atomic && is_b_in_atomic, is_node_in_atomic);
+        case ltl::kind::weak_until:
+            return implication(is_node_in_atomic && !is_b_in_atomic, is_a_in_atomic) &&
+                   implication(is_b_in_atomic, is_node_in_atomic);
+        default:
+            return true;
     }
-
-    return true;
 }
 
 void converting::detect_initial_states(const ltl::node_t &formula)
 {
     m_A_0.clear();
+    const literal_t initial = to_literal(formula);
     for (size_t i = 0; i < m_At.size(); ++i)
     {
-        if (is_in(m_At[i], formula))
+        if (test(get_signs(i), initial.m_index) != initial.m_negated)
             m_A_0.insert(i);
     }
 }
 
-void converting::generate_atomic_plurality()
+bool converting::generate_atomic_plurality(const std::stop_token &stop, const progress_callback_t &callback)
 {
-    state_t neg_storage{m_closure};
-    /// rule 1 prediction
-    for (ltl::node_t &it : neg_storage)
-        it = ltl_negation::construct(std::move(it));
+    enumeration_t enumeration{stop, callback ? &callback : nullptr};
 
-    recursive_brute_force(m_At, m_closure, neg_storage);
-}
-
-void converting::recursive_brute_force(std::vector<state_t> &states, const state_t &pos, const state_t &neg,
-                                      state_t curr, size_t i)
-{
-    if (pos.size() != neg.size())
-        return;
-
-    // initialization of input default parameter
-    if (i == 0)
-        curr = state_t{pos.size(), nullptr};
-
-    if (i == pos.size())
+    const size_t workers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    if (m_closure.size() < parallel_closure_size || workers == 1)
     {
-        if (std::all_of(curr.begin(), curr.end(),
-                        [&](const ltl::node_t &node) -> bool
-                        { return satisfies_atomic_rules(curr, node); }))
-        {
-            states.emplace_back(curr);
-        }
+        signs_t curr(m_words, 0, m_resource);
+        recursive_brute_force(m_signs, curr, enumeration, 0);
+        if (stop.stop_requested())
+            return false;
 
-        return;
+        store_atoms();
+        return true;
     }
 
-    curr[i] = pos[i];
-    recursive_brute_force(states, pos, neg, curr, i+1);
-
-    curr[i] = neg[i];
-    recursive_brute_force(states, pos, neg, curr, i+1);
-}
+    // split the search by the signs of the first closure elements: task number is a prefix assignment
+    // in the order of @recursive_brute_force (the first element is the most significant, positive goes first)
+    const size_t prefix_size = std::min<size_t>(std::bit_width(workers * tasks_per_worker - 1), m_closure.size());
+    const size_t tasks = size_t{1} << prefix_size;
 
-bool converting::conjunction_rule(const state_t &atomic, const ltl::node_t &node)
-{
-    if (node->get_kind() != ltl::kind::conjunction)
-        return true;
+    // the resource of the conversion isn't synchronized: each task fills its own arena,
+    // signs are copied to the resource of the conversion by the merge and the arenas are released at once
+    const auto arenas = std::make_unique<std::pmr::monotonic_buffer_resource[]>(tasks);
+    std::vector<signs_t> buffers{};
+    buffers.reserve(tasks);
+    for (size_t task = 0; task < tasks; ++task)
+        buffers.emplace_back(&arenas[task]);
 
-    /// \note this gives us an understanding of whether there was a negation before the node
-    // whether negation
-    const bool is_node_in_atomic = is_in(atomic, node);
-
-    const auto node_conjunction = std::dynamic_pointer_cast<ltl_conjunction>(node);
+    worker_pool::instance().run(tasks, [&](const size_t task)
+    {
+        signs_t curr(m_words, 0, &arenas[task]);
+        for (size_t i = 0; i < prefix_size; ++i)
+        {
+            if (((task >> (prefix_size - 1 - i)) & 1) == 0)
+                curr[i / 64] |= uint64_t{1} << (i % 64);
+            if (!satisfies_atomic_rules(curr.data(), i))
+                return;
+        }
 
-    const bool is_a_in_atomic = is_in(atomic, node_conjunction->m_left);
-    const bool is_b_in_atomic = is_in(atomic, node_conjunction->m_right);
+        recursive_brute_force(buffers[task], curr, enumeration, prefix_size);
+    });
+    if (stop.stop_requested())
+        return false;
 
-    const bool rule = is_a_in_atomic && is_b_in_atomic;
+    // merge in the task order: atom indexes don't depend on the number of threads
+    size_t size = 0;
+    for (const auto &buffer : buffers)
+        size += buffer.size();
+    m_signs.reserve(size);
+    for (const auto &buffer : buffers)
+        m_signs.insert(m_signs.end(), buffer.begin(), buffer.end());
 
-    return is_node_in_atomic == rule;
+    store_atoms();
+    return true;
 }
 
-bool converting::until_rules(const state_t &atomic, const ltl::node_t &node)
+void converting::recursive_brute_force(signs_t &signs, signs_t &curr, enumeration_t &enumeration,
+                                       const size_t i) const
 {
-    if (node->get_kind() != ltl::kind::until)
-        return true;
-
-    const auto &node_until = std::dynamic_pointer_cast<ltl_until>(node);
+    if (enumeration.m_stop.stop_requested())
+        return;
 
-    const bool is_node_in_atomic = is_in(atomic, node_until);
-    const bool is_a_in_atomic = is_in(atomic, node_until->m_left);
-    const bool is_b_in_atomic = is_in(atomic, node_until->m_right);
+    if (i == m_rules.size())
+    {
+        signs.insert(signs.end(), curr.begin(), curr.end());
 
-    const bool rule_3 = implication(is_node_in_atomic && !is_b_in_atomic, is_a_in_atomic);
-    const bool rule_4 = implication(is_b_in_atomic, is_node_in_atomic);
+        const size_t atoms = enumeration.m_atoms.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (enumeration.m_callback && atoms % atoms_per_report == 0)
+        {
+            std::lock_guard lock{enumeration.m_mutex};
+            (*enumeration.m_callback)(progress{phase::atoms, atoms, 0, 0});
+        }
+        return;
+    }
 
-    return rule_3 && rule_4;
-}
+    const uint64_t bit = uint64_t{1} << (i % 64);
 
-bool converting::satisfies_atomic_rules(const state_t &atomic, const ltl::node_t &node)
-{
-    if (const auto kind = node->get_kind(); kind == ltl::kind::negation)
-    {
-        return satisfies_atomic_rules(atomic, std::dynamic_pointer_cast<ltl_negation>(node)->m_negformula);
-    }
-    else if (kind == ltl::kind::conjunction)
-    {
-        /// rule 2
-        return conjunction_rule(atomic, node);
-    }
-    else if (kind == ltl::kind::until)
-    {
-        /// rule 3-4
-        return until_rules(atomic, node);
-    }
+    curr[i / 64] |= bit;
+    if (satisfies_atomic_rules(curr.data(), i))
+        recursive_brute_force(signs, curr, enumeration, i+1);
 
-    return true;
+    curr[i / 64] &= ~bit;
+    if (satisfies_atomic_rules(curr.data(), i))
+        recursive_brute_force(signs, curr, enumeration, i+1);
 }
 
 void converting::fill_closure(const ltl::node_t& formula)
@@ -254,6 +737,34 @@ void converting::fill_closure(const ltl::node_t& formula)
             fill_closure(std::dynamic_pointer_cast<ltl_until>(formula)->m_right);
             break;
         }
+        case ltl::kind::disjunction:
+        {
+            fill_closure(std::dynamic_pointer_cast<ltl_disjunction>(formula)->m_left);
+            fill_closure(std::dynamic_pointer_cast<ltl_disjunction>(formula)->m_right);
+            break;
+        }
+        case ltl::kind::finally:
+        {
+            fill_closure(std::dynamic_pointer_cast<ltl_finally>(formula)->m_fformula);
+            break;
+        }
+        case ltl::kind::globally:
+        {
+            fill_closure(std::dynamic_pointer_cast<ltl_globally>(formula)->m_gformula);
+            break;
+        }
+        case ltl::kind::release:
+        {
+            fill_closure(std::dynamic_pointer_cast<ltl_release>(formula)->m_left);
+            fill_closure(std::dynamic_pointer_cast<ltl_release>(formula)->m_right);
+            break;
+        }
+        case ltl::kind::weak_until:
+        {
+            fill_closure(std::dynamic_pointer_cast<ltl_weak_until>(formula)->m_left);
+            fill_closure(std::dynamic_pointer_cast<ltl_weak_until>(formula)->m_right);
+            break;
+        }
         default:
             assert("Shouldn't happen - we must cover all cases");
             break;
@@ -271,56 +782,129 @@ void converting::add_to_closure(const ltl::node_t& formula)
     m_closure.emplace_back(formula);
 }
 
-void converting::ltl_to_nga()
+bool converting::ltl_to_nga(const std::stop_token &stop, const progress_callback_t &callback)
 {
-    indexes_container_t C_indexes = m_A_0;
+    // states are inserted and erased all the time: the pool reuses their nodes instead of growing the arena
+    std::pmr::unsynchronized_pool_resource queue_resource{m_resource};
+    indexes_container_t C_indexes{m_A_0, &queue_resource};
     while (!C_indexes.empty())
     {
         const size_t s_index = *C_indexes.begin();
         C_indexes.erase(s_index);
-        const state_t &s = m_At[s_index];
+        const uint64_t *s = get_signs(s_index);
 
         m_A.insert(s_index);
 
         size_t i = 0;
-        for (const ltl::node_t &alpha : m_closure)
+        for (const size_t alpha : m_temporal)
         {
             /// rule Z1
             if (z1_rule(s, alpha))
                 m_F[i].insert(s_index);
-            // till next until
-            if (alpha->get_kind() == ltl::kind::until)
+            // till next eventuality
+            if (is_eventuality_kind(m_rules[alpha].m_kind))
                 ++i;
         }
 
-        indexes_container_t next_states_indexes{};
+        indexes_container_t next_states_indexes{m_resource};
         for (size_t sd_index = 0; sd_index < m_At.size(); ++sd_index)
         {
-            /// rule R1-R2
-            if (std::all_of(s.begin(), s.end(),
-                            [&](const ltl::node_t &node) -> bool
-                            { return satisfies_r_rules(s, m_At[sd_index], node); }))
+            if (stop.stop_requested())
+                return false;
+
+            /// rules R1-R6
+            const uint64_t *sd = get_signs(sd_index);
+            if (std::all_of(m_temporal.begin(), m_temporal.end(),
+                            [&](const size_t alpha) -> bool { return satisfies_r_rules(s, sd, alpha); }))
             {
                 next_states_indexes.insert(sd_index);
-                if (!std::any_of(m_A.begin(), m_A.end(),
-                                 [&sd_index](const size_t &it) -> bool
-                                 { return it == sd_index; }))
+                if (!m_A.contains(sd_index))
                     C_indexes.insert(sd_index);
             }
         }
 
         if (!next_states_indexes.empty())
         {
-            // collect all atomic propositions that become curves
-            std::set<ltl_atom::index_atom_t> s_proposition{};
-            for (const auto &node : s)
-                if (node->get_kind() == ltl::kind::atom)
-                    s_proposition.insert(std::dynamic_pointer_cast<ltl_atom>(node)->m_index);
-
             assert(m_table[s_index].second.empty() && "Should be empty according to the algorithm");
-            m_table[s_index] = std::make_pair(std::move(s_proposition), std::move(next_states_indexes));
+            m_table[s_index] = std::make_pair(get_letter(s), std::move(next_states_indexes));
         }
+
+        if (callback)
+            callback(progress{phase::transitions, m_At.size(), m_A.size(), C_indexes.size()});
     }
+
+    return true;
+}
+
+bool converting::refine_nga(const size_t old_closure_size, const std::vector<size_t> &refinement,
+                            const table_t &table, const finals_t &finals, const std::stop_token &stop)
+{
+    // an atom of the previous closure that was refined to the @m_At[index]
+    std::vector<size_t> parents(m_At.size());
+    for (size_t i = 0; i + 1 < refinement.size(); ++i)
+        for (size_t index = refinement[i]; index < refinement[i + 1]; ++index)
+            parents[index] = i;
+
+    const auto first_new = std::lower_bound(m_temporal.begin(), m_temporal.end(), old_closure_size);
+    const size_t old_eventualities = static_cast<size_t>(
+            std::count_if(m_temporal.begin(), first_new,
+                          [this](const size_t alpha) -> bool { return is_eventuality_kind(m_rules[alpha].m_kind); }));
+
+    // states are inserted and erased all the time: the pool reuses their nodes instead of growing the arena
+    std::pmr::unsynchronized_pool_resource queue_resource{m_resource};
+    indexes_container_t C_indexes{m_A_0, &queue_resource};
+    while (!C_indexes.empty())
+    {
+        const size_t s_index = *C_indexes.begin();
+        C_indexes.erase(s_index);
+        const uint64_t *s = get_signs(s_index);
+        const size_t parent = parents[s_index];
+
+        m_A.insert(s_index);
+
+        /// rule Z1: previous eventualities are decided by the parent atom
+        for (const auto &[i, value] : finals)
+            if (value.contains(parent))
+                m_F[i].insert(s_index);
+        size_t i = old_eventualities;
+        for (auto it = first_new; it != m_temporal.end(); ++it)
+        {
+            if (z1_rule(s, *it))
+                m_F[i].insert(s_index);
+            // till next eventuality
+            if (is_eventuality_kind(m_rules[*it].m_kind))
+                ++i;
+        }
+
+        const auto parent_transitions = table.find(parent);
+        if (parent_transitions == table.end())
+            continue;
+
+        /// rules R1-R6: previous elements are satisfied by the parent transitions
+        indexes_container_t next_states_indexes{m_resource};
+        for (const size_t parent_sd : parent_transitions->second.second)
+        {
+            for (size_t sd_index = refinement[parent_sd]; sd_index < refinement[parent_sd + 1]; ++sd_index)
+            {
+                if (stop.stop_requested())
+                    return false;
+
+                const uint64_t *sd = get_signs(sd_index);
+                if (std::all_of(first_new, m_temporal.end(),
+                                [&](const size_t alpha) -> bool { return satisfies_r_rules(s, sd, alpha); }))
+                {
+                    next_states_indexes.insert(sd_index);
+                    if (!m_A.contains(sd_index))
+                        C_indexes.insert(sd_index);
+                }
+            }
+        }
+
+        if (!next_states_indexes.empty())
+            m_table[s_index] = std::make_pair(get_letter(s), std::move(next_states_indexes));
+    }
+
+    return true;
 }
 
 } // namespace ltl
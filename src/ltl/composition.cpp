@@ -0,0 +1,289 @@
+#include "ltl/composition.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace ltl
+{
+
+namespace
+{
+
+/// \brief All combinations of one choice per component, the last component changes first
+std::vector<composition::state_t> cartesian_product(const std::vector<std::vector<size_t>> &choices)
+{
+    std::vector<composition::state_t> result{};
+    if (std::any_of(choices.begin(), choices.end(), [](const auto &it) -> bool { return it.empty(); }))
+        return result;
+
+    composition::state_t curr(choices.size());
+    std::vector<size_t> positions(choices.size(), 0);
+    while (true)
+    {
+        for (size_t i = 0; i < choices.size(); ++i)
+            curr[i] = choices[i][positions[i]];
+        result.push_back(curr);
+
+        size_t i = choices.size();
+        while (i > 0 && ++positions[i - 1] == choices[i - 1].size())
+            positions[--i] = 0;
+        if (i == 0)
+            break;
+    }
+
+    return result;
+}
+
+} // namespace anonymous
+
+std::shared_ptr<composition> composition::construct(ltl::node_t&& formula)
+{
+    return std::shared_ptr<composition>(new composition(std::move(formula)));
+}
+
+ltl::node_t composition::get_ltl_formula() const
+{
+    return m_formula;
+}
+
+const std::vector<std::shared_ptr<converting>>& composition::get_components() const
+{
+    return m_components;
+}
+
+std::vector<composition::state_t> composition::get_initial_states() const
+{
+    std::vector<std::vector<size_t>> choices{};
+    choices.reserve(m_data.size());
+    for (const auto &it : m_data)
+        choices.emplace_back(it.m_A_0.begin(), it.m_A_0.end());
+
+    return cartesian_product(choices);
+}
+
+converting::alphabet_t composition::get_alphabet(const state_t &state) const
+{
+    converting::alphabet_t alph{};
+    for (size_t i = 0; i < m_data.size(); ++i)
+        if (const auto it = m_data[i].m_table.find(state[i]); it != m_data[i].m_table.end())
+            alph.insert(it->second.first.begin(), it->second.first.end());
+
+    return alph;
+}
+
+std::vector<composition::state_t> composition::get_next_states(const state_t &state) const
+{
+    std::vector<std::vector<size_t>> choices{};
+    choices.reserve(m_data.size());
+    for (size_t i = 0; i < m_data.size(); ++i)
+    {
+        const auto it = m_data[i].m_table.find(state[i]);
+        if (it == m_data[i].m_table.end())
+            return {};
+        choices.emplace_back(it->second.second.begin(), it->second.second.end());
+    }
+
+    return cartesian_product(choices);
+}
+
+size_t composition::get_final_sets_count() const
+{
+    return m_finals_count;
+}
+
+bool composition::is_final(const size_t set, const state_t &state) const
+{
+    // the last component which final sets start before the @set
+    const auto it = std::upper_bound(m_data.begin(), m_data.end(), set,
+                                     [](const size_t value, const component &c) -> bool
+                                     { return value < c.m_first_final; });
+    if (it == m_data.begin())
+        return false;
+
+    const auto i = static_cast<size_t>(std::distance(m_data.begin(), it)) - 1;
+    const auto finals = m_data[i].m_F.find(set - m_data[i].m_first_final);
+    return finals != m_data[i].m_F.end() && finals->second.contains(state[i]);
+}
+
+std::shared_ptr<converting> composition::materialize(std::vector<state_t> *states) const
+{
+    auto result = std::shared_ptr<converting>(new converting());
+    result->m_formula = m_formula;
+    // negation nodes of the atoms are allocated by the components
+    result->m_owners.assign(m_components.begin(), m_components.end());
+    for (const auto &it : m_components)
+    {
+        const auto &closure = it->get_closure();
+        result->m_closure.insert(result->m_closure.end(), closure.begin(), closure.end());
+        const auto representation = it->get_automaton_representation();
+        result->ap.insert(std::get<1>(representation).begin(), std::get<1>(representation).end());
+    }
+
+    std::map<state_t, size_t> indexes{};
+    std::vector<state_t> queue{};
+    auto get_index = [&](const state_t &state) -> size_t
+    {
+        const auto [it, inserted] = indexes.emplace(state, indexes.size());
+        if (inserted)
+        {
+            queue.push_back(state);
+
+            converting::state_t &atom = result->m_At.emplace_back();
+            atom.reserve(result->m_closure.size());
+            for (size_t i = 0; i < m_components.size(); ++i)
+            {
+                const auto &part = m_components[i]->get_concrete_state(state[i]);
+                atom.insert(atom.end(), part.begin(), part.end());
+            }
+        }
+        return it->second;
+    };
+
+    for (const auto &state : get_initial_states())
+        result->m_A_0.insert(get_index(state));
+
+    for (size_t s_index = 0; s_index < queue.size(); ++s_index)
+    {
+        const state_t state = queue[s_index];
+        result->m_A.insert(s_index);
+
+        for (size_t set = 0; set < m_finals_count; ++set)
+            if (is_final(set, state))
+                result->m_F[set].insert(s_index);
+
+        converting::indexes_container_t next_states_indexes{result->m_resource};
+        for (const auto &next : get_next_states(state))
+            next_states_indexes.insert(get_index(next));
+
+        if (!next_states_indexes.empty())
+            result->m_table[s_index] = std::make_pair(get_alphabet(state), std::move(next_states_indexes));
+    }
+
+    // rules and signs are needed to conjoin the result
+    result->compile_rules(0);
+    result->collect_signs();
+
+    if (states)
+        *states = std::move(queue);
+
+    return result;
+}
+
+composition::composition(ltl::node_t&& formula) : m_formula(formula)
+{
+    std::vector<ltl::node_t> conjuncts{};
+    collect_conjuncts(m_formula, conjuncts);
+
+    // union-find of the conjuncts that share atomic propositions
+    std::vector<size_t> parents(conjuncts.size());
+    std::iota(parents.begin(), parents.end(), 0);
+    auto find = [&parents](size_t i) -> size_t
+    {
+        while (parents[i] != i)
+            i = parents[i] = parents[parents[i]];
+        return i;
+    };
+
+    std::map<ltl_atom::index_atom_t, size_t> owners{};
+    for (size_t i = 0; i < conjuncts.size(); ++i)
+    {
+        std::set<ltl_atom::index_atom_t> ap{};
+        collect_propositions(conjuncts[i], ap);
+        for (const auto index : ap)
+        {
+            if (const auto [it, inserted] = owners.emplace(index, i); !inserted)
+            {
+                const size_t a = find(i);
+                const size_t b = find(it->second);
+                // the first conjunct of the group is its root: groups keep the order of the formula
+                parents[std::max(a, b)] = std::min(a, b);
+            }
+        }
+    }
+
+    std::map<size_t, ltl::node_t> groups{};
+    for (size_t i = 0; i < conjuncts.size(); ++i)
+    {
+        auto &group = groups[find(i)];
+        group = group ? ltl_conjunction::construct(std::move(group), ltl::node_t{conjuncts[i]}) : conjuncts[i];
+    }
+
+    for (auto &[_, group] : groups)
+    {
+        auto algo = converting::construct(std::move(group));
+
+        component data{};
+        std::tie(std::ignore, std::ignore, data.m_table, data.m_A_0, data.m_F) = algo->get_automaton_representation();
+        data.m_first_final = m_finals_count;
+
+        const auto &closure = algo->get_closure();
+        m_finals_count += static_cast<size_t>(std::count_if(closure.begin(), closure.end(),
+                                                            converting::is_eventuality));
+
+        m_components.push_back(std::move(algo));
+        m_data.push_back(std::move(data));
+    }
+}
+
+void composition::collect_conjuncts(const ltl::node_t &formula, std::vector<ltl::node_t> &conjuncts)
+{
+    if (formula->get_kind() != ltl::kind::conjunction)
+    {
+        conjuncts.push_back(formula);
+        return;
+    }
+
+    const auto &node_conjunction = std::dynamic_pointer_cast<ltl_conjunction>(formula);
+    collect_conjuncts(node_conjunction->m_left, conjuncts);
+    collect_conjuncts(node_conjunction->m_right, conjuncts);
+}
+
+void composition::collect_propositions(const ltl::node_t &formula, std::set<ltl_atom::index_atom_t> &ap)
+{
+    switch (formula->get_kind())
+    {
+        case ltl::kind::one:
+            break;
+        case ltl::kind::atom:
+            ap.insert(std::dynamic_pointer_cast<ltl_atom>(formula)->m_index);
+            break;
+        case ltl::kind::negation:
+            collect_propositions(std::dynamic_pointer_cast<ltl_negation>(formula)->m_negformula, ap);
+            break;
+        case ltl::kind::next:
+            collect_propositions(std::dynamic_pointer_cast<ltl_next>(formula)->m_xformula, ap);
+            break;
+        case ltl::kind::finally:
+            collect_propositions(std::dynamic_pointer_cast<ltl_finally>(formula)->m_fformula, ap);
+            break;
+        case ltl::kind::globally:
+            collect_propositions(std::dynamic_pointer_cast<ltl_globally>(formula)->m_gformula, ap);
+            break;
+        case ltl::kind::conjunction:
+            collect_propositions(std::dynamic_pointer_cast<ltl_conjunction>(formula)->m_left, ap);
+            collect_propositions(std::dynamic_pointer_cast<ltl_conjunction>(formula)->m_right, ap);
+            break;
+        case ltl::kind::disjunction:
+            collect_propositions(std::dynamic_pointer_cast<ltl_disjunction>(formula)->m_left, ap);
+            collect_propositions(std::dynamic_pointer_cast<ltl_disjunction>(formula)->m_right, ap);
+            break;
+        case ltl::kind::until:
+            collect_propositions(std::dynamic_pointer_cast<ltl_until>(formula)->m_left, ap);
+            collect_propositions(std::dynamic_pointer_cast<ltl_until>(formula)->m_right, ap);
+            break;
+        case ltl::kind::release:
+            collect_propositions(std::dynamic_pointer_cast<ltl_release>(formula)->m_left, ap);
+            collect_propositions(std::dynamic_pointer_cast<ltl_release>(formula)->m_right, ap);
+            break;
+        case ltl::kind::weak_until:
+            collect_propositions(std::dynamic_pointer_cast<ltl_weak_until>(formula)->m_left, ap);
+            collect_propositions(std::dynamic_pointer_cast<ltl_weak_until>(formula)->m_right, ap);
+            break;
+        default:
+            assert(!"Shouldn't happen - we must cover all cases");
+            break;
+    }
+}
+
+} // namespace ltl
@@ -1,20 +1,49 @@
 #include "ltl/ltl.hpp"
 
-#include <utility>
 #include <cassert>
+#include <new>
+#include <utility>
 
 // TODO: make a common storage for identical ltl-objects
 
 namespace ltl
 {
 
+namespace
+{
+
+/// \brief Place the node and its control block in the memory of @resource.
+/// @construct_at builds the node in the given storage: constructors are available to the factories only
+template<typename T, typename Fn>
+std::shared_ptr<T> allocate_node(std::pmr::memory_resource *resource, Fn &&construct_at)
+{
+    std::pmr::polymorphic_allocator<T> allocator{resource};
+    T *node = construct_at(allocator.allocate(1));
+    return std::shared_ptr<T>(node,
+                              [resource](T *it)
+                              {
+                                  it->~T();
+                                  std::pmr::polymorphic_allocator<T>{resource}.deallocate(it, 1);
+                              },
+                              allocator);
+}
+
+} // namespace anonymous
+
 ltl::ltl(const kind kind)
         : m_kind(kind)
 {}
 
-ltl::node_t ltl_one::construct()
+std::string ltl::to_string() const
+{
+    std::string out;
+    write(out);
+    return out;
+}
+
+ltl::node_t ltl_one::construct(std::pmr::memory_resource *resource)
 {
-    return std::shared_ptr<ltl_one>(new ltl_one());
+    return allocate_node<ltl_one>(resource, [&](void *it) { return new (it) ltl_one(); });
 }
 
 bool operator== (const std::shared_ptr<ltl_one>& left, const std::shared_ptr<ltl_one>& right)
@@ -22,18 +51,18 @@ bool operator== (const std::shared_ptr<ltl_one>& left, const std::shared_ptr<ltl
     return true;
 }
 
-std::string ltl_one::to_string() const
+void ltl_one::write(std::string &out) const
 {
-    return "true";
+    out += "true";
 }
 
 ltl_one::ltl_one()
         : ltl(kind::one)
 {}
 
-ltl::node_t ltl_atom::construct(const index_atom_t index)
+ltl::node_t ltl_atom::construct(const index_atom_t index, std::pmr::memory_resource *resource)
 {
-    return std::shared_ptr<ltl_atom>(new ltl_atom(index));
+    return allocate_node<ltl_atom>(resource, [&](void *it) { return new (it) ltl_atom(index); });
 }
 
 bool operator== (const std::shared_ptr<ltl_atom>& left, const std::shared_ptr<ltl_atom>& right)
@@ -41,16 +70,17 @@ bool operator== (const std::shared_ptr<ltl_atom>& left, const std::shared_ptr<lt
     return left->m_index == right->m_index;
 }
 
-std::string ltl_atom::to_string() const
+void ltl_atom::write(std::string &out) const
 {
-    return "p" + std::to_string(m_index);
+    out += 'p';
+    out += std::to_string(m_index);
 }
 
 ltl_atom::ltl_atom(const index_atom_t index)
         : ltl(kind::atom), m_index(index)
 {}
 
-ltl::node_t ltl_negation::construct(node_t &&formula)
+ltl::node_t ltl_negation::construct(node_t &&formula, std::pmr::memory_resource *resource)
 {
     if (!formula)
     {
@@ -62,7 +92,7 @@ ltl::node_t ltl_negation::construct(node_t &&formula)
     if (formula->get_kind() == ltl::kind::negation)
         return std::dynamic_pointer_cast<ltl_negation>(formula)->m_negformula;
 
-    return std::shared_ptr<ltl_negation>(new ltl_negation(formula));
+    return allocate_node<ltl_negation>(resource, [&](void *it) { return new (it) ltl_negation(formula); });
 }
 
 bool operator== (const std::shared_ptr<ltl_negation>& left, const std::shared_ptr<ltl_negation>& right)
@@ -70,9 +100,10 @@ bool operator== (const std::shared_ptr<ltl_negation>& left, const std::shared_pt
     return left->m_negformula == right->m_negformula;
 }
 
-std::string ltl_negation::to_string() const
+void ltl_negation::write(std::string &out) const
 {
-    return "! " + m_negformula->to_string();
+    out += "! ";
+    m_negformula->write(out);
 }
 
 ltl_negation::ltl_negation(node_t formula)
@@ -82,7 +113,7 @@ ltl_negation::ltl_negation(node_t formula)
     assert(m_negformula->get_kind() != ltl::kind::negation && "Inner formula can't be negative");
 }
 
-ltl::node_t ltl_conjunction::construct(node_t &&left, node_t &&right)
+ltl::node_t ltl_conjunction::construct(node_t &&left, node_t &&right, std::pmr::memory_resource *resource)
 {
     if (!left || !right)
     {
@@ -100,13 +131,13 @@ ltl::node_t ltl_conjunction::construct(node_t &&left, node_t &&right)
         (right->get_kind() == ltl::kind::negation &&
          std::dynamic_pointer_cast<ltl_negation>(right)->m_negformula->get_kind() == ltl::kind::one))
     {
-        return ltl_negation::construct(ltl_one::construct());
+        return ltl_negation::construct(ltl_one::construct(resource), resource);
     }
     // optimization block with equal children
     if (left == right)
         return left;
 
-    return std::shared_ptr<ltl_conjunction>(new ltl_conjunction(left, right));
+    return allocate_node<ltl_conjunction>(resource, [&](void *it) { return new (it) ltl_conjunction(left, right); });
 }
 
 bool operator== (const std::shared_ptr<ltl_conjunction>& left, const std::shared_ptr<ltl_conjunction>& right)
@@ -115,9 +146,12 @@ bool operator== (const std::shared_ptr<ltl_conjunction>& left, const std::shared
             (left->m_left == right->m_right && left->m_right == right->m_left));
 }
 
-std::string ltl_conjunction::to_string() const
+void ltl_conjunction::write(std::string &out) const
 {
-    return "^ " + m_left->to_string() + " " + m_right->to_string();
+    out += "^ ";
+    m_left->write(out);
+    out += ' ';
+    m_right->write(out);
 }
 
 ltl_conjunction::ltl_conjunction(node_t left, node_t right)
@@ -126,7 +160,7 @@ ltl_conjunction::ltl_conjunction(node_t left, node_t right)
     assert(m_left && m_right && "Left and Right should be set");
 }
 
-ltl::node_t ltl_next::construct(node_t &&xformula)
+ltl::node_t ltl_next::construct(node_t &&xformula, std::pmr::memory_resource *resource)
 {
     if (!xformula)
     {
@@ -134,7 +168,7 @@ ltl::node_t ltl_next::construct(node_t &&xformula)
         return nullptr;
     }
 
-    return std::shared_ptr<ltl_next>(new ltl_next(xformula));
+    return allocate_node<ltl_next>(resource, [&](void *it) { return new (it) ltl_next(xformula); });
 }
 
 bool operator== (const std::shared_ptr<ltl_next>& left, const std::shared_ptr<ltl_next>& right)
@@ -142,9 +176,10 @@ bool operator== (const std::shared_ptr<ltl_next>& left, const std::shared_ptr<lt
     return left->m_xformula == right->m_xformula;
 }
 
-std::string ltl_next::to_string() const
+void ltl_next::write(std::string &out) const
 {
-    return "X " + m_xformula->to_string();
+    out += "X ";
+    m_xformula->write(out);
 }
 
 ltl_next::ltl_next(node_t formula)
@@ -153,7 +188,7 @@ ltl_next::ltl_next(node_t formula)
     assert(m_xformula && "Formula should be set");
 }
 
-ltl::node_t ltl_until::construct(node_t &&left, node_t &&right)
+ltl::node_t ltl_until::construct(node_t &&left, node_t &&right, std::pmr::memory_resource *resource)
 {
     if (!left || !right)
     {
@@ -161,7 +196,7 @@ ltl::node_t ltl_until::construct(node_t &&left, node_t &&right)
         return nullptr;
     }
 
-    return std::shared_ptr<ltl_until>(new ltl_until(left, right));
+    return allocate_node<ltl_until>(resource, [&](void *it) { return new (it) ltl_until(left, right); });
 }
 
 bool operator== (const std::shared_ptr<ltl_until>& left, const std::shared_ptr<ltl_until>& right)
@@ -169,9 +204,12 @@ bool operator== (const std::shared_ptr<ltl_until>& left, const std::shared_ptr<l
     return left->m_left == right->m_left && left->m_right == right->m_right;
 }
 
-std::string ltl_until::to_string() const
+void ltl_until::write(std::string &out) const
 {
-    return "U " + m_left->to_string() + " " + m_right->to_string();
+    out += "U ";
+    m_left->write(out);
+    out += ' ';
+    m_right->write(out);
 }
 
 ltl_until::ltl_until(node_t left, node_t right)
@@ -180,6 +218,169 @@ ltl_until::ltl_until(node_t left, node_t right)
     assert(m_left && m_right && "Left and Right should be set");
 }
 
+ltl::node_t ltl_disjunction::construct(node_t &&left, node_t &&right, std::pmr::memory_resource *resource)
+{
+    if (!left || !right)
+    {
+        assert(left && right && "Empty inner formula");
+        return nullptr;
+    }
+
+    // optimization block with true/false child
+    auto is_false = [](const node_t &node) -> bool
+    {
+        return node->get_kind() == ltl::kind::negation &&
+               std::dynamic_pointer_cast<ltl_negation>(node)->m_negformula->get_kind() == ltl::kind::one;
+    };
+    if (left->get_kind() == ltl::kind::one || right->get_kind() == ltl::kind::one)
+        return ltl_one::construct(resource);
+    if (is_false(left))
+        return right;
+    if (is_false(right))
+        return left;
+    // optimization block with equal children
+    if (left == right)
+        return left;
+
+    return allocate_node<ltl_disjunction>(resource, [&](void *it) { return new (it) ltl_disjunction(left, right); });
+}
+
+bool operator== (const std::shared_ptr<ltl_disjunction>& left, const std::shared_ptr<ltl_disjunction>& right)
+{
+    return ((left->m_left == right->m_left && left->m_right == right->m_right) ||
+            (left->m_left == right->m_right && left->m_right == right->m_left));
+}
+
+void ltl_disjunction::write(std::string &out) const
+{
+    out += "| ";
+    m_left->write(out);
+    out += ' ';
+    m_right->write(out);
+}
+
+ltl_disjunction::ltl_disjunction(node_t left, node_t right)
+        : ltl(kind::disjunction), m_left(std::move(left)), m_right(std::move(right))
+{
+    assert(m_left && m_right && "Left and Right should be set");
+}
+
+ltl::node_t ltl_finally::construct(node_t &&fformula, std::pmr::memory_resource *resource)
+{
+    if (!fformula)
+    {
+        assert(fformula && "Empty inner formula");
+        return nullptr;
+    }
+
+    return allocate_node<ltl_finally>(resource, [&](void *it) { return new (it) ltl_finally(fformula); });
+}
+
+bool operator== (const std::shared_ptr<ltl_finally>& left, const std::shared_ptr<ltl_finally>& right)
+{
+    return left->m_fformula == right->m_fformula;
+}
+
+void ltl_finally::write(std::string &out) const
+{
+    out += "F ";
+    m_fformula->write(out);
+}
+
+ltl_finally::ltl_finally(node_t formula)
+        : ltl(kind::finally), m_fformula(std::move(formula))
+{
+    assert(m_fformula && "Formula should be set");
+}
+
+ltl::node_t ltl_globally::construct(node_t &&gformula, std::pmr::memory_resource *resource)
+{
+    if (!gformula)
+    {
+        assert(gformula && "Empty inner formula");
+        return nullptr;
+    }
+
+    return allocate_node<ltl_globally>(resource, [&](void *it) { return new (it) ltl_globally(gformula); });
+}
+
+bool operator== (const std::shared_ptr<ltl_globally>& left, const std::shared_ptr<ltl_globally>& right)
+{
+    return left->m_gformula == right->m_gformula;
+}
+
+void ltl_globally::write(std::string &out) const
+{
+    out += "G ";
+    m_gformula->write(out);
+}
+
+ltl_globally::ltl_globally(node_t formula)
+        : ltl(kind::globally), m_gformula(std::move(formula))
+{
+    assert(m_gformula && "Formula should be set");
+}
+
+ltl::node_t ltl_release::construct(node_t &&left, node_t &&right, std::pmr::memory_resource *resource)
+{
+    if (!left || !right)
+    {
+        assert(left && right && "Empty inner formula");
+        return nullptr;
+    }
+
+    return allocate_node<ltl_release>(resource, [&](void *it) { return new (it) ltl_release(left, right); });
+}
+
+bool operator== (const std::shared_ptr<ltl_release>& left, const std::shared_ptr<ltl_release>& right)
+{
+    return left->m_left == right->m_left && left->m_right == right->m_right;
+}
+
+void ltl_release::write(std::string &out) const
+{
+    out += "R ";
+    m_left->write(out);
+    out += ' ';
+    m_right->write(out);
+}
+
+ltl_release::ltl_release(node_t left, node_t right)
+        : ltl(kind::release), m_left(std::move(left)), m_right(std::move(right))
+{
+    assert(m_left && m_right && "Left and Right should be set");
+}
+
+ltl::node_t ltl_weak_until::construct(node_t &&left, node_t &&right, std::pmr::memory_resource *resource)
+{
+    if (!left || !right)
+    {
+        assert(left && right && "Empty inner formula");
+        return nullptr;
+    }
+
+    return allocate_node<ltl_weak_until>(resource, [&](void *it) { return new (it) ltl_weak_until(left, right); });
+}
+
+bool operator== (const std::shared_ptr<ltl_weak_until>& left, const std::shared_ptr<ltl_weak_until>& right)
+{
+    return left->m_left == right->m_left && left->m_right == right->m_right;
+}
+
+void ltl_weak_until::write(std::string &out) const
+{
+    out += "W ";
+    m_left->write(out);
+    out += ' ';
+    m_right->write(out);
+}
+
+ltl_weak_until::ltl_weak_until(node_t left, node_t right)
+        : ltl(kind::weak_until), m_left(std::move(left)), m_right(std::move(right))
+{
+    assert(m_left && m_right && "Left and Right should be set");
+}
+
 
 bool operator== (const ltl::node_t& left, const ltl::node_t& right)
 {
@@ -206,6 +407,16 @@ bool operator== (const ltl::node_t& left, const ltl::node_t& right)
                 return fn.operator()<ltl_next>();
             case ltl::kind::until:
                 return fn.operator()<ltl_until>();
+            case ltl::kind::disjunction:
+                return fn.operator()<ltl_disjunction>();
+            case ltl::kind::finally:
+                return fn.operator()<ltl_finally>();
+            case ltl::kind::globally:
+                return fn.operator()<ltl_globally>();
+            case ltl::kind::release:
+                return fn.operator()<ltl_release>();
+            case ltl::kind::weak_until:
+                return fn.operator()<ltl_weak_until>();
             default:
                 assert(!"Incorrect proposition during comparing");
         }
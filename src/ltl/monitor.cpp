@@ -0,0 +1,389 @@
+#include "ltl/monitor.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+
+namespace ltl
+{
+
+std::shared_ptr<monitor> monitor::construct(ltl::node_t&& formula, std::string *diagnostic)
+{
+    auto report = [diagnostic](std::string message) -> std::shared_ptr<monitor>
+    {
+        if (diagnostic)
+            *diagnostic = std::move(message);
+        return nullptr;
+    };
+
+    if (!formula)
+        return report("empty LTL-formula");
+
+    const fragment kind = detect_fragment(formula);
+    if (kind == fragment::undefined)
+        return report("formula " + formula->to_string() + " is outside of the safety and co-safety fragments: "
+                      "its negation normal form mixes F/U with G/R/W operators");
+
+    // co-safety formula is satisfied exactly when its (safety) negation is violated
+    const auto algo = converting::construct(kind == fragment::safety ? std::move(formula)
+                                                                     : ltl_negation::construct(std::move(formula)));
+
+    const auto ap = std::get<1>(algo->get_automaton_representation());
+    if (ap.size() > max_propositions)
+        return report("too many atomic propositions for the dense alphabet: " + std::to_string(ap.size()) +
+                      " (at most " + std::to_string(max_propositions) + ")");
+
+    auto result = std::shared_ptr<monitor>(new monitor());
+    result->m_fragment = kind;
+    result->m_propositions.assign(ap.begin(), ap.end());
+    result->m_letters_count = size_t{1} << ap.size();
+    result->determinize(*algo);
+    result->minimize();
+
+    return result;
+}
+
+monitor::fragment monitor::detect_fragment(const ltl::node_t &formula)
+{
+    if (is_in_fragment(formula, false, fragment::safety))
+        return fragment::safety;
+    if (is_in_fragment(formula, false, fragment::co_safety))
+        return fragment::co_safety;
+
+    return fragment::undefined;
+}
+
+monitor::fragment monitor::get_fragment() const
+{
+    return m_fragment;
+}
+
+const std::vector<ltl_atom::index_atom_t>& monitor::get_propositions() const
+{
+    return m_propositions;
+}
+
+size_t monitor::get_states_count() const
+{
+    return m_verdicts.size();
+}
+
+size_t monitor::get_letters_count() const
+{
+    return m_letters_count;
+}
+
+monitor::state_index_t monitor::get_initial_state() const
+{
+    return m_initial;
+}
+
+monitor::verdict monitor::get_verdict(const state_index_t state) const
+{
+    return m_verdicts[state];
+}
+
+const std::vector<monitor::state_index_t>& monitor::get_table() const
+{
+    return m_table;
+}
+
+bool monitor::is_in_fragment(const ltl::node_t &formula, const bool negated, const fragment fragment)
+{
+    // operator of the negation normal form is either "safety" (G, R, W) or "co-safety" (F, U)
+    auto allowed = [negated, fragment](const bool is_safety_operator) -> bool
+    {
+        return (is_safety_operator != negated) == (fragment == fragment::safety);
+    };
+
+    switch (formula->get_kind())
+    {
+        case ltl::kind::one:
+        case ltl::kind::atom:
+            return true;
+        case ltl::kind::negation:
+            return is_in_fragment(std::dynamic_pointer_cast<ltl_negation>(formula)->m_negformula, !negated, fragment);
+        case ltl::kind::next:
+            return is_in_fragment(std::dynamic_pointer_cast<ltl_next>(formula)->m_xformula, negated, fragment);
+        case ltl::kind::conjunction:
+        {
+            const auto &node = std::dynamic_pointer_cast<ltl_conjunction>(formula);
+            return is_in_fragment(node->m_left, negated, fragment) && is_in_fragment(node->m_right, negated, fragment);
+        }
+        case ltl::kind::disjunction:
+        {
+            const auto &node = std::dynamic_pointer_cast<ltl_disjunction>(formula);
+            return is_in_fragment(node->m_left, negated, fragment) && is_in_fragment(node->m_right, negated, fragment);
+        }
+        case ltl::kind::finally:
+            return allowed(false) &&
+                   is_in_fragment(std::dynamic_pointer_cast<ltl_finally>(formula)->m_fformula, negated, fragment);
+        case ltl::kind::globally:
+            return allowed(true) &&
+                   is_in_fragment(std::dynamic_pointer_cast<ltl_globally>(formula)->m_gformula, negated, fragment);
+        case ltl::kind::until:
+        {
+            const auto &node = std::dynamic_pointer_cast<ltl_until>(formula);
+            return allowed(false) &&
+                   is_in_fragment(node->m_left, negated, fragment) && is_in_fragment(node->m_right, negated, fragment);
+        }
+        case ltl::kind::release:
+        {
+            const auto &node = std::dynamic_pointer_cast<ltl_release>(formula);
+            return allowed(true) &&
+                   is_in_fragment(node->m_left, negated, fragment) && is_in_fragment(node->m_right, negated, fragment);
+        }
+        case ltl::kind::weak_until:
+        {
+            const auto &node = std::dynamic_pointer_cast<ltl_weak_until>(formula);
+            return allowed(true) &&
+                   is_in_fragment(node->m_left, negated, fragment) && is_in_fragment(node->m_right, negated, fragment);
+        }
+        default:
+            assert(!"Shouldn't happen - we must cover all cases");
+            return false;
+    }
+}
+
+std::vector<bool> monitor::find_live_states(const converting &algo)
+{
+    const auto [states, _, table, initials, final_sets] = algo.get_automaton_representation();
+    const auto &closure = algo.get_closure();
+    const auto eventualities = static_cast<size_t>(std::count_if(closure.begin(), closure.end(),
+                                                                 converting::is_eventuality));
+
+    const size_t size = states.empty() ? 0 : *states.rbegin() + 1;
+    auto next_states = [&table](const size_t index) -> const converting::indexes_container_t&
+    {
+        static const converting::indexes_container_t empty{};
+        const auto it = table.find(index);
+        return it == table.end() ? empty : it->second.second;
+    };
+
+    // strongly connected components (iterative Tarjan)
+    constexpr size_t undefined = static_cast<size_t>(-1);
+    std::vector<size_t> order(size, undefined), low(size, 0), component(size, undefined);
+    std::vector<bool> on_stack(size, false);
+    std::vector<size_t> stack{};
+    size_t counter = 0, components = 0;
+    for (const size_t root : states)
+    {
+        if (order[root] != undefined)
+            continue;
+
+        std::vector<std::pair<size_t, converting::indexes_container_t::const_iterator>> calls{};
+        auto enter = [&](const size_t v)
+        {
+            order[v] = low[v] = counter++;
+            stack.push_back(v);
+            on_stack[v] = true;
+            calls.emplace_back(v, next_states(v).begin());
+        };
+
+        enter(root);
+        while (!calls.empty())
+        {
+            auto &[v, it] = calls.back();
+            if (it != next_states(v).end())
+            {
+                const size_t w = *it++;
+                if (order[w] == undefined)
+                    enter(w);
+                else if (on_stack[w])
+                    low[v] = std::min(low[v], order[w]);
+                continue;
+            }
+
+            const size_t finished = v;
+            calls.pop_back();
+            if (!calls.empty())
+                low[calls.back().first] = std::min(low[calls.back().first], low[finished]);
+            if (low[finished] != order[finished])
+                continue;
+
+            for (size_t w = undefined; w != finished;)
+            {
+                w = stack.back();
+                stack.pop_back();
+                on_stack[w] = false;
+                component[w] = components;
+            }
+            ++components;
+        }
+    }
+
+    // accepting component has a cycle inside and visits each final states plurality
+    std::vector<bool> has_cycle(components, false);
+    std::vector<std::vector<bool>> visits(components, std::vector<bool>(eventualities, false));
+    for (const size_t s : states)
+    {
+        for (const size_t sd : next_states(s))
+            if (component[s] == component[sd])
+                has_cycle[component[s]] = true;
+        for (const auto &[i, value] : final_sets)
+            if (i < eventualities && value.contains(s))
+                visits[component[s]][i] = true;
+    }
+
+    std::vector<std::vector<size_t>> previous(size);
+    std::vector<size_t> queue{};
+    std::vector<bool> live(size, false);
+    for (const size_t s : states)
+    {
+        for (const size_t sd : next_states(s))
+            previous[sd].push_back(s);
+
+        const size_t c = component[s];
+        if (has_cycle[c] && std::all_of(visits[c].begin(), visits[c].end(), [](const bool it) { return it; }))
+        {
+            live[s] = true;
+            queue.push_back(s);
+        }
+    }
+
+    while (!queue.empty())
+    {
+        const size_t sd = queue.back();
+        queue.pop_back();
+        for (const size_t s : previous[sd])
+        {
+            if (!live[s])
+            {
+                live[s] = true;
+                queue.push_back(s);
+            }
+        }
+    }
+
+    return live;
+}
+
+void monitor::determinize(const converting &algo)
+{
+    const auto [states, _, table, initials, final_sets] = algo.get_automaton_representation();
+    const std::vector<bool> live = find_live_states(algo);
+    auto is_live = [&live](const size_t index) -> bool { return index < live.size() && live[index]; };
+
+    // letter read from the each state
+    std::map<size_t, letter_t> letters{};
+    for (const auto &[index, value] : table)
+    {
+        letter_t letter = 0;
+        for (const auto p : value.first)
+        {
+            const auto it = std::lower_bound(m_propositions.begin(), m_propositions.end(), p);
+            letter |= letter_t{1} << static_cast<size_t>(std::distance(m_propositions.begin(), it));
+        }
+        letters[index] = letter;
+    }
+
+    using subset_t = std::vector<size_t>;
+    std::map<subset_t, state_index_t> indexes{};
+    std::vector<subset_t> queue{};
+    auto get_index = [&](subset_t &&subset) -> state_index_t
+    {
+        const auto [it, inserted] = indexes.emplace(subset, static_cast<state_index_t>(indexes.size()));
+        if (inserted)
+            queue.push_back(std::move(subset));
+        return it->second;
+    };
+
+    subset_t initial{};
+    std::copy_if(initials.begin(), initials.end(), std::back_inserter(initial), is_live);
+    m_initial = get_index(std::move(initial));
+
+    for (size_t i = 0; i < queue.size(); ++i)
+    {
+        const verdict final_verdict = m_fragment == fragment::safety ? verdict::violated : verdict::satisfied;
+        m_verdicts.push_back(queue[i].empty() ? final_verdict : verdict::inconclusive);
+
+        std::map<letter_t, std::set<size_t>> next{};
+        for (const size_t s : queue[i])
+        {
+            const auto it = table.find(s);
+            if (it == table.end())
+                continue;
+            auto &next_states = next[letters[s]];
+            std::copy_if(it->second.second.begin(), it->second.second.end(),
+                         std::inserter(next_states, next_states.end()), is_live);
+        }
+
+        std::vector<state_index_t> row(m_letters_count);
+        const state_index_t sink = queue[i].empty() ? static_cast<state_index_t>(i) : get_index(subset_t{});
+        std::fill(row.begin(), row.end(), sink);
+        for (auto &[letter, next_states] : next)
+            row[letter] = get_index(subset_t{next_states.begin(), next_states.end()});
+
+        m_table.insert(m_table.end(), row.begin(), row.end());
+    }
+}
+
+void monitor::minimize()
+{
+    const size_t size = m_verdicts.size();
+
+    std::vector<state_index_t> classes(size);
+    size_t classes_count = 0;
+    {
+        std::map<verdict, state_index_t> initial_classes{};
+        for (size_t s = 0; s < size; ++s)
+        {
+            const auto [it, _] = initial_classes.emplace(m_verdicts[s], initial_classes.size());
+            classes[s] = it->second;
+        }
+        classes_count = initial_classes.size();
+    }
+
+    // refine until the number of classes is stable
+    while (true)
+    {
+        std::map<std::vector<state_index_t>, state_index_t> signatures{};
+        std::vector<state_index_t> refined(size);
+        for (size_t s = 0; s < size; ++s)
+        {
+            std::vector<state_index_t> signature{};
+            signature.reserve(m_letters_count + 1);
+            signature.push_back(classes[s]);
+            for (size_t letter = 0; letter < m_letters_count; ++letter)
+                signature.push_back(classes[m_table[s * m_letters_count + letter]]);
+
+            const auto [it, _] = signatures.emplace(std::move(signature), signatures.size());
+            refined[s] = it->second;
+        }
+
+        classes = std::move(refined);
+        if (signatures.size() == classes_count)
+            break;
+        classes_count = signatures.size();
+    }
+
+    // renumber the classes in the breadth-first order from the initial state
+    std::vector<state_index_t> representatives{};
+    std::vector<state_index_t> numbers(classes_count, static_cast<state_index_t>(-1));
+    auto visit = [&](const state_index_t s) -> state_index_t
+    {
+        if (numbers[classes[s]] == static_cast<state_index_t>(-1))
+        {
+            numbers[classes[s]] = static_cast<state_index_t>(representatives.size());
+            representatives.push_back(s);
+        }
+        return numbers[classes[s]];
+    };
+
+    visit(m_initial);
+    std::vector<state_index_t> table{};
+    std::vector<verdict> verdicts{};
+    for (size_t i = 0; i < representatives.size(); ++i)
+    {
+        const state_index_t s = representatives[i];
+        verdicts.push_back(m_verdicts[s]);
+        for (size_t letter = 0; letter < m_letters_count; ++letter)
+            table.push_back(visit(m_table[s * m_letters_count + letter]));
+    }
+
+    m_initial = 0;
+    m_table = std::move(table);
+    m_verdicts = std::move(verdicts);
+}
+
+} // namespace ltl
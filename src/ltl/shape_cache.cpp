@@ -0,0 +1,323 @@
+#include "ltl/shape_cache.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+
+namespace ltl
+{
+
+namespace
+{
+
+/// \brief Skeleton file: magic, signature and the skeleton in the native byte order (the cache is local)
+constexpr char file_magic[] = "LTLSHAPE2";
+
+template<typename T>
+void write_value(std::ostream &out, const T &value)
+{
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template<typename T>
+void write_vector(std::ostream &out, const std::vector<T> &values)
+{
+    write_value(out, values.size());
+    out.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+void write_lists(std::ostream &out, const std::vector<std::pair<size_t, std::vector<size_t>>> &lists)
+{
+    write_value(out, lists.size());
+    for (const auto &[key, values] : lists)
+    {
+        write_value(out, key);
+        write_vector(out, values);
+    }
+}
+
+template<typename T>
+bool read_value(std::istream &in, T &value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+template<typename T>
+bool read_vector(std::istream &in, std::vector<T> &values, const size_t limit)
+{
+    size_t size = 0;
+    if (!read_value(in, size) || size > limit)
+        return false;
+
+    values.resize(size);
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(values.data()),
+                                     static_cast<std::streamsize>(size * sizeof(T))));
+}
+
+bool read_lists(std::istream &in, std::vector<std::pair<size_t, std::vector<size_t>>> &lists, const size_t limit)
+{
+    size_t size = 0;
+    if (!read_value(in, size) || size > limit)
+        return false;
+
+    lists.resize(size);
+    for (auto &[key, values] : lists)
+        if (!read_value(in, key) || !read_vector(in, values, limit))
+            return false;
+
+    return true;
+}
+
+void append_bytes(std::string &signature, const size_t value)
+{
+    signature.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+} // namespace anonymous
+
+shape_cache::shape_cache(std::string directory, const size_t capacity)
+        : m_directory(std::move(directory)),
+          m_capacity(std::max<size_t>(capacity, 1))
+{}
+
+std::shared_ptr<converting> shape_cache::convert(ltl::node_t&& formula, std::pmr::memory_resource *resource)
+{
+    auto result = std::shared_ptr<converting>(new converting(std::move(formula), resource));
+    result->fill_closure(result->m_formula);
+    result->compile_rules(0);
+
+    const std::string signature = get_signature(*result);
+    std::shared_ptr<const skeleton> found = find(signature);
+    if (found)
+    {
+        ++m_memory_hits;
+    }
+    else if ((found = load(signature, *result)))
+    {
+        ++m_disk_hits;
+        insert(signature, found);
+    }
+
+    if (found)
+    {
+        instantiate(*result, *found);
+        return result;
+    }
+
+    ++m_misses;
+    result->generate_atomic_plurality();
+    result->detect_initial_states(result->m_formula);
+    result->ltl_to_nga();
+
+    auto value = std::make_shared<const skeleton>(extract(*result));
+    save(signature, *value);
+    insert(signature, std::move(value));
+
+    return result;
+}
+
+shape_cache::statistics shape_cache::get_statistics() const
+{
+    return statistics{m_memory_hits, m_disk_hits, m_misses};
+}
+
+std::string shape_cache::get_signature(const converting &algo)
+{
+    std::string signature{};
+    signature.reserve((algo.m_rules.size() + 1) * 5 * sizeof(size_t));
+    for (const auto &record : algo.m_rules)
+    {
+        // a proposition is its own closure element: equal propositions are the same operand index
+        append_bytes(signature, static_cast<size_t>(record.m_kind));
+        append_bytes(signature, record.m_left.m_index);
+        append_bytes(signature, record.m_left.m_negated);
+        append_bytes(signature, record.m_right.m_index);
+        append_bytes(signature, record.m_right.m_negated);
+    }
+
+    const auto initial = algo.to_literal(algo.m_formula);
+    append_bytes(signature, initial.m_index);
+    append_bytes(signature, initial.m_negated);
+
+    return signature;
+}
+
+shape_cache::skeleton shape_cache::extract(const converting &algo)
+{
+    skeleton value{};
+    value.m_words = algo.m_words;
+    value.m_signs.assign(algo.m_signs.begin(), algo.m_signs.end());
+    value.m_states.assign(algo.m_A.begin(), algo.m_A.end());
+    value.m_initial.assign(algo.m_A_0.begin(), algo.m_A_0.end());
+    for (const auto &[s, transition] : algo.m_table)
+        value.m_transitions.emplace_back(s, std::vector<size_t>(transition.second.begin(), transition.second.end()));
+    for (const auto &[set, states] : algo.m_F)
+        value.m_finals.emplace_back(set, std::vector<size_t>(states.begin(), states.end()));
+
+    return value;
+}
+
+void shape_cache::instantiate(converting &algo, const skeleton &value)
+{
+    algo.m_signs.assign(value.m_signs.begin(), value.m_signs.end());
+    algo.store_atoms();
+
+    algo.m_A.insert(value.m_states.begin(), value.m_states.end());
+    algo.m_A_0.insert(value.m_initial.begin(), value.m_initial.end());
+    for (const auto &[s, next] : value.m_transitions)
+    {
+        algo.m_table[s] = std::make_pair(algo.get_letter(algo.get_signs(s)),
+                                         converting::indexes_container_t(next.begin(), next.end(), algo.m_resource));
+    }
+    for (const auto &[set, states] : value.m_finals)
+        algo.m_F[set].insert(states.begin(), states.end());
+}
+
+std::shared_ptr<const shape_cache::skeleton> shape_cache::find(const std::string &signature)
+{
+    std::lock_guard lock{m_mutex};
+    const auto it = m_skeletons.find(signature);
+    if (it == m_skeletons.end())
+        return nullptr;
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->second;
+}
+
+void shape_cache::insert(const std::string &signature, std::shared_ptr<const skeleton> value)
+{
+    std::lock_guard lock{m_mutex};
+    if (const auto it = m_skeletons.find(signature); it != m_skeletons.end())
+    {
+        // converted concurrently by another caller
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return;
+    }
+
+    m_lru.emplace_front(signature, std::move(value));
+    m_skeletons[signature] = m_lru.begin();
+    if (m_lru.size() > m_capacity)
+    {
+        m_skeletons.erase(m_lru.back().first);
+        m_lru.pop_back();
+    }
+}
+
+std::shared_ptr<const shape_cache::skeleton> shape_cache::load(const std::string &signature,
+                                                               const converting &algo) const
+{
+    if (m_directory.empty())
+        return nullptr;
+
+    std::ifstream in{get_path(signature), std::ios::binary};
+    if (!in)
+        return nullptr;
+
+    char magic[sizeof(file_magic)] = {};
+    std::string saved_signature{};
+    std::vector<char> bytes{};
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), file_magic) ||
+        !read_vector(in, bytes, signature.size()))
+    {
+        return nullptr;
+    }
+    // different shape with the same hash
+    if (!std::equal(bytes.begin(), bytes.end(), signature.begin(), signature.end()))
+        return nullptr;
+
+    auto value = std::make_shared<skeleton>();
+    constexpr size_t limit = size_t{1} << 32;
+    if (!read_value(in, value->m_words) || value->m_words == 0 || value->m_words != algo.m_words ||
+        !read_vector(in, value->m_signs, limit) ||
+        !read_vector(in, value->m_states, limit) || !read_vector(in, value->m_initial, limit) ||
+        !read_lists(in, value->m_transitions, limit) || !read_lists(in, value->m_finals, limit))
+    {
+        return nullptr;
+    }
+
+    // damaged file shouldn't break the automaton
+    if (value->m_signs.size() % value->m_words != 0)
+        return nullptr;
+
+    const size_t atoms_count = value->m_signs.size() / value->m_words;
+    const auto eventualities = static_cast<size_t>(std::count_if(algo.m_closure.begin(), algo.m_closure.end(),
+                                                                 converting::is_eventuality));
+    auto is_atom = [atoms_count](const size_t index) -> bool { return index < atoms_count; };
+    auto is_list_of_atoms = [&is_atom](const std::pair<size_t, std::vector<size_t>> &list) -> bool
+    {
+        return std::all_of(list.second.begin(), list.second.end(), is_atom);
+    };
+    if (!std::all_of(value->m_states.begin(), value->m_states.end(), is_atom) ||
+        !std::all_of(value->m_initial.begin(), value->m_initial.end(), is_atom) ||
+        !std::all_of(value->m_transitions.begin(), value->m_transitions.end(),
+                     [&](const auto &it) -> bool { return is_atom(it.first) && is_list_of_atoms(it); }) ||
+        !std::all_of(value->m_finals.begin(), value->m_finals.end(),
+                     [&](const auto &it) -> bool { return it.first < eventualities && is_list_of_atoms(it); }))
+    {
+        return nullptr;
+    }
+
+    // atoms follow the rules of the closure and have no signs beyond it
+    const size_t tail = algo.m_closure.size() % 64;
+    for (size_t atom = 0; atom < atoms_count; ++atom)
+    {
+        const uint64_t *signs = value->m_signs.data() + atom * value->m_words;
+        if (tail != 0 && (signs[value->m_words - 1] >> tail) != 0)
+            return nullptr;
+        for (size_t i = 0; i < algo.m_rules.size(); ++i)
+            if (!algo.satisfies_atomic_rules(signs, i))
+                return nullptr;
+    }
+
+    return value;
+}
+
+void shape_cache::save(const std::string &signature, const skeleton &value) const
+{
+    if (m_directory.empty())
+        return;
+
+    std::error_code error{};
+    std::filesystem::create_directories(m_directory, error);
+
+    // written aside and renamed: readers never see a partial file, writers of other processes have other names
+    const std::string path = get_path(signature);
+    std::ostringstream suffix{};
+    suffix << "." << ::getpid() << "." << std::this_thread::get_id() << ".tmp";
+    const std::string temporary = path + suffix.str();
+    {
+        std::ofstream out{temporary, std::ios::binary};
+        out.write(file_magic, sizeof(file_magic));
+        write_vector(out, std::vector<char>(signature.begin(), signature.end()));
+        write_value(out, value.m_words);
+        write_vector(out, value.m_signs);
+        write_vector(out, value.m_states);
+        write_vector(out, value.m_initial);
+        write_lists(out, value.m_transitions);
+        write_lists(out, value.m_finals);
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+        std::filesystem::remove(temporary, error);
+}
+
+std::string shape_cache::get_path(const std::string &signature) const
+{
+    std::ostringstream name{};
+    name << std::hex << std::hash<std::string>{}(signature) << ".shape";
+
+    return (std::filesystem::path{m_directory} / name.str()).string();
+}
+
+} // namespace ltl
@@ -0,0 +1,168 @@
+#include "ltl/tgba.hpp"
+
+#include <algorithm>
+#include <map>
+
+namespace ltl
+{
+
+std::shared_ptr<tgba> tgba::construct(const converting &algo)
+{
+    auto result = std::shared_ptr<tgba>(new tgba());
+    std::vector<edge> labels{};
+    std::vector<std::vector<packed_edge_t>> edges{};
+    result->translate(algo, labels, edges);
+    result->merge(labels, edges);
+
+    return result;
+}
+
+ltl::node_t tgba::get_ltl_formula() const
+{
+    return m_formula;
+}
+
+const std::vector<ltl_atom::index_atom_t>& tgba::get_propositions() const
+{
+    return m_propositions;
+}
+
+size_t tgba::get_states_count() const
+{
+    return m_edges.size();
+}
+
+tgba::state_index_t tgba::get_initial_state() const
+{
+    return m_initial;
+}
+
+size_t tgba::get_acceptance_sets_count() const
+{
+    return m_acceptance_sets_count;
+}
+
+const std::vector<tgba::edge>& tgba::get_edges(const state_index_t state) const
+{
+    return m_edges[state];
+}
+
+void tgba::translate(const converting &algo, std::vector<edge> &labels,
+                     std::vector<std::vector<packed_edge_t>> &edges)
+{
+    const auto [_, ap, table, initials, finals] = algo.get_automaton_representation();
+    m_formula = algo.get_ltl_formula();
+    m_propositions.assign(ap.begin(), ap.end());
+
+    const auto &closure = algo.get_closure();
+    m_acceptance_sets_count = static_cast<size_t>(std::count_if(closure.begin(), closure.end(),
+                                                                converting::is_eventuality));
+
+    const size_t atoms_count = algo.get_atoms_count();
+    std::vector<edge> atom_labels(atoms_count);
+    for (size_t s = 0; s < atoms_count; ++s)
+    {
+        for (const auto &node : algo.get_concrete_state(s))
+            if (node->get_kind() == ltl::kind::atom)
+                atom_labels[s].m_letter.push_back(std::dynamic_pointer_cast<ltl_atom>(node)->m_index);
+        std::sort(atom_labels[s].m_letter.begin(), atom_labels[s].m_letter.end());
+    }
+
+    // the keys are ascending, so are the marks
+    for (const auto &[set, value] : finals)
+        for (const size_t s : value)
+            atom_labels[s].m_marks.push_back(set);
+
+    // the edge into an atom is labeled by the atom: atoms with the same label share it
+    std::map<edge, packed_edge_t> label_indexes{};
+    std::vector<packed_edge_t> atom_edges(atoms_count);
+    for (size_t s = 0; s < atoms_count; ++s)
+    {
+        const auto [it, inserted] = label_indexes.emplace(atom_labels[s], labels.size());
+        if (inserted)
+            labels.push_back(atom_labels[s]);
+        atom_edges[s] = (it->second << 32) | static_cast<state_index_t>(s + 1);
+    }
+
+    m_initial = 0;
+    edges.assign(atoms_count + 1, {});
+    auto add_edges = [&](const size_t from, const converting::indexes_container_t &targets)
+    {
+        edges[from].reserve(targets.size());
+        for (const size_t sd : targets)
+            edges[from].push_back(atom_edges[sd]);
+    };
+
+    add_edges(0, initials);
+    for (const auto &[s, transition] : table)
+        add_edges(s + 1, transition.second);
+}
+
+void tgba::merge(const std::vector<edge> &labels, const std::vector<std::vector<packed_edge_t>> &edges)
+{
+    const size_t size = edges.size();
+    constexpr packed_edge_t label_mask = ~packed_edge_t{0} << 32;
+
+    auto map_targets = [&edges](const size_t s, const auto &map) -> std::vector<packed_edge_t>
+    {
+        std::vector<packed_edge_t> result = edges[s];
+        for (packed_edge_t &it : result)
+            it = (it & label_mask) | map(static_cast<state_index_t>(it));
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+
+        return result;
+    };
+
+    // refine until the number of classes is stable
+    std::vector<state_index_t> classes(size, 0);
+    size_t classes_count = 1;
+    while (true)
+    {
+        auto get_class = [&classes](const state_index_t s) -> state_index_t { return classes[s]; };
+
+        std::map<std::pair<state_index_t, std::vector<packed_edge_t>>, state_index_t> signatures{};
+        std::vector<state_index_t> refined(size);
+        for (size_t s = 0; s < size; ++s)
+        {
+            const auto [it, _] = signatures.emplace(std::make_pair(classes[s], map_targets(s, get_class)),
+                                                    signatures.size());
+            refined[s] = it->second;
+        }
+
+        classes = std::move(refined);
+        if (signatures.size() == classes_count)
+            break;
+        classes_count = signatures.size();
+    }
+
+    // renumber the classes in the breadth-first order from the initial state: unreachable atoms are dropped
+    std::vector<state_index_t> representatives{};
+    std::vector<state_index_t> numbers(classes_count, static_cast<state_index_t>(-1));
+    auto visit = [&](const state_index_t s) -> state_index_t
+    {
+        if (numbers[classes[s]] == static_cast<state_index_t>(-1))
+        {
+            numbers[classes[s]] = static_cast<state_index_t>(representatives.size());
+            representatives.push_back(s);
+        }
+        return numbers[classes[s]];
+    };
+
+    visit(m_initial);
+    m_edges.clear();
+    for (size_t i = 0; i < representatives.size(); ++i)
+    {
+        std::vector<edge> &state_edges = m_edges.emplace_back();
+        for (const packed_edge_t it : map_targets(representatives[i], visit))
+        {
+            state_edges.push_back(labels[it >> 32]);
+            state_edges.back().m_target = static_cast<state_index_t>(it);
+        }
+        std::sort(state_edges.begin(), state_edges.end());
+    }
+
+    m_initial = 0;
+}
+
+} // namespace ltl
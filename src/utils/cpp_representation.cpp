@@ -0,0 +1,316 @@
+#include "utils/cpp_representation.hpp"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+namespace cpp
+{
+
+namespace
+{
+
+/// \brief Dense numbering of the automaton: state j of the generated code is the atom a<atoms[j]>
+struct dense_automaton
+{
+    std::vector<size_t> m_atoms{};
+    std::vector<ltl::ltl_atom::index_atom_t> m_propositions{};
+    /// \brief letter (bit mask over @m_propositions) to leave the each state, if it has next states
+    std::vector<std::pair<bool, uint64_t>> m_letters{};
+    std::vector<std::vector<size_t>> m_next{};
+    std::vector<size_t> m_initials{};
+    std::vector<std::vector<size_t>> m_finals{};
+};
+
+size_t dense_index_of(const std::vector<ltl::ltl_atom::index_atom_t> &propositions,
+                      const ltl::ltl_atom::index_atom_t p)
+{
+    const auto it = std::lower_bound(propositions.begin(), propositions.end(), p);
+    return static_cast<size_t>(std::distance(propositions.begin(), it));
+}
+
+/// \brief Valuations and visited final states pluralities are 64-bit masks with a spare bit
+/// \return false, if the automaton doesn't fit them
+bool fits_masks(const std::shared_ptr<ltl::converting> &algo, std::string *diagnostic)
+{
+    const auto &closure = algo->get_closure();
+    const size_t propositions = static_cast<size_t>(std::count_if(
+            closure.begin(), closure.end(),
+            [](const ltl::ltl::node_t &node) -> bool { return node->get_kind() == ltl::ltl::kind::atom; }));
+    const size_t final_sets = static_cast<size_t>(std::count_if(closure.begin(), closure.end(),
+                                                                ltl::converting::is_eventuality));
+    if (propositions < 64 && final_sets < 64)
+        return true;
+
+    if (diagnostic)
+    {
+        *diagnostic = propositions >= 64 ? "formula has " + std::to_string(propositions) + " propositions, "
+                                           "the monitor supports at most 63"
+                                         : "formula has " + std::to_string(final_sets) + " eventualities, "
+                                           "the monitor supports at most 63";
+    }
+    return false;
+}
+
+std::optional<dense_automaton> make_dense(const std::shared_ptr<ltl::converting> &algo, std::string *diagnostic)
+{
+    if (!fits_masks(algo, diagnostic))
+        return std::nullopt;
+
+    const auto &[states, ap, transitions, initials, final_sets] = algo->get_automaton_representation();
+
+    dense_automaton result{};
+    result.m_atoms.assign(states.begin(), states.end());
+    result.m_propositions.assign(ap.begin(), ap.end());
+
+    auto dense_index = [&result](const size_t atom) -> size_t
+    {
+        const auto it = std::lower_bound(result.m_atoms.begin(), result.m_atoms.end(), atom);
+        return static_cast<size_t>(std::distance(result.m_atoms.begin(), it));
+    };
+
+    result.m_letters.resize(result.m_atoms.size(), {false, 0});
+    result.m_next.resize(result.m_atoms.size());
+    for (const auto &[index, value] : transitions)
+    {
+        uint64_t letter = 0;
+        for (const auto p : value.first)
+            letter |= uint64_t{1} << dense_index_of(result.m_propositions, p);
+
+        const size_t s = dense_index(index);
+        result.m_letters[s] = {true, letter};
+        for (const auto sd : value.second)
+            result.m_next[s].push_back(dense_index(sd));
+    }
+
+    for (const auto index : initials)
+        result.m_initials.push_back(dense_index(index));
+
+    // one plurality per eventuality, even if it has no final states
+    const auto &closure = algo->get_closure();
+    result.m_finals.resize(static_cast<size_t>(std::count_if(closure.begin(), closure.end(),
+                                                             ltl::converting::is_eventuality)));
+    for (const auto &[i, value] : final_sets)
+        for (const auto index : value)
+            result.m_finals[i].push_back(dense_index(index));
+
+    return result;
+}
+
+std::string to_hex(const uint64_t value)
+{
+    std::ostringstream out;
+    out << "0x" << std::hex << value << "ull";
+    return out.str();
+}
+
+/// \return words of the state set as the brace-enclosed initializer
+std::string to_words(const std::vector<size_t> &states, const size_t words)
+{
+    std::vector<uint64_t> result(words, 0);
+    for (const auto s : states)
+        result[s / 64] |= uint64_t{1} << (s % 64);
+
+    std::string text{"{"};
+    for (size_t w = 0; w < words; ++w)
+        text += (w == 0 ? "" : ", ") + to_hex(result[w]);
+    return text + "}";
+}
+
+} // namespace anonymous
+
+std::string convert_to_cpp(const std::shared_ptr<ltl::converting>& algo, const std::string &name,
+                           std::string *diagnostic)
+{
+    const auto dense = make_dense(algo, diagnostic);
+    if (!dense)
+        return {};
+
+    const dense_automaton &automaton = *dense;
+    const size_t states_count = automaton.m_atoms.size();
+    const size_t words = states_count / 64 + 1;
+
+    std::ostringstream out;
+    out << "#pragma once\n\n"
+        << "// Generated by ltl_converter: monitor of the automaton for the LTL-formula\n"
+        << "// " << algo->get_ltl_formula()->to_string() << "\n\n"
+        << "#include <array>\n#include <cstddef>\n#include <cstdint>\n\n"
+        << "namespace " << name << "\n{\n\n";
+
+    out << "/// \\brief Bit j of a valuation stands for the proposition p<propositions[j]>\n"
+        << "inline constexpr std::array<uint32_t, " << automaton.m_propositions.size() << "> propositions{";
+    for (size_t j = 0; j < automaton.m_propositions.size(); ++j)
+        out << (j == 0 ? "" : ", ") << automaton.m_propositions[j];
+    out << "};\n\n";
+
+    out << "/// \\brief State j of the monitor is the atom a<atoms[j]> of the automaton\n"
+        << "inline constexpr std::array<std::size_t, " << states_count << "> atoms{";
+    for (size_t j = 0; j < states_count; ++j)
+        out << (j == 0 ? "" : ", ") << automaton.m_atoms[j];
+    out << "};\n\n";
+
+    out << "inline constexpr std::size_t states_count = " << states_count << ";\n"
+        << "inline constexpr std::size_t final_sets_count = " << automaton.m_finals.size() << ";\n\n";
+
+    out << "struct state_set\n{\n"
+        << "    std::array<uint64_t, " << words << "> words{};\n\n"
+        << "    [[nodiscard]] constexpr bool contains(const std::size_t state) const\n    {\n"
+        << "        return (words[state / 64] >> (state % 64)) & 1u;\n    }\n\n"
+        << "    [[nodiscard]] constexpr bool empty() const\n    {\n"
+        << "        for (const auto word : words)\n            if (word != 0)\n                return false;\n"
+        << "        return true;\n    }\n\n"
+        << "    [[nodiscard]] constexpr bool intersects(const state_set &other) const\n    {\n"
+        << "        for (std::size_t w = 0; w < words.size(); ++w)\n"
+        << "            if ((words[w] & other.words[w]) != 0)\n                return true;\n"
+        << "        return false;\n    }\n\n"
+        << "    friend constexpr bool operator== (const state_set &left, const state_set &right) = default;\n"
+        << "};\n\n";
+
+    out << "inline constexpr state_set initial_states{" << to_words(automaton.m_initials, words) << "};\n\n";
+
+    out << "inline constexpr std::array<state_set, " << automaton.m_finals.size() << "> final_sets{{";
+    for (size_t k = 0; k < automaton.m_finals.size(); ++k)
+        out << (k == 0 ? "" : ", ") << "{" << to_words(automaton.m_finals[k], words) << "}";
+    out << "}};\n\n";
+
+    uint64_t valuation_mask = 0;
+    for (size_t j = 0; j < automaton.m_propositions.size(); ++j)
+        valuation_mask |= uint64_t{1} << j;
+
+    out << "/// \\brief Tracks all runs of the automaton on the read prefix\n"
+        << "class monitor\n{\npublic:\n"
+        << "    using valuation_t = uint64_t;\n\n"
+        << "    constexpr void reset()\n    {\n"
+        << "        m_states = initial_states;\n        m_visited = 0;\n        m_rounds = 0;\n    }\n\n"
+        << "    /// \\brief Read one letter: bit j is set when p<propositions[j]> holds\n"
+        << "    constexpr void step(valuation_t valuation)\n    {\n"
+        << "        valuation &= " << to_hex(valuation_mask) << ";\n"
+        << "        const auto &current = m_states.words;\n"
+        << "        state_set next{};\n"
+        << "        switch (valuation)\n        {\n";
+
+    // states grouped by the letter they read
+    std::map<uint64_t, std::vector<size_t>> letters{};
+    for (size_t s = 0; s < states_count; ++s)
+        if (automaton.m_letters[s].first)
+            letters[automaton.m_letters[s].second].push_back(s);
+
+    for (const auto &[letter, sources] : letters)
+    {
+        out << "            case " << to_hex(letter) << ":\n";
+        for (const auto s : sources)
+        {
+            std::vector<uint64_t> next(words, 0);
+            for (const auto sd : automaton.m_next[s])
+                next[sd / 64] |= uint64_t{1} << (sd % 64);
+
+            out << "                if (current[" << s / 64 << "] & " << to_hex(uint64_t{1} << (s % 64)) << ")\n"
+                << "                {\n";
+            for (size_t w = 0; w < words; ++w)
+                if (next[w] != 0)
+                    out << "                    next.words[" << w << "] |= " << to_hex(next[w]) << ";\n";
+            out << "                }\n";
+        }
+        out << "                break;\n";
+    }
+    out << "            default:\n                break;\n        }\n"
+        << "        m_states = next;\n"
+        << "        if (!alive())\n            return;\n\n";
+    if (automaton.m_finals.empty())
+    {
+        out << "        // no final states pluralities: each letter read by a run completes a round\n"
+            << "        ++m_rounds;\n";
+    }
+    else
+    {
+        out << "        for (std::size_t k = 0; k < final_sets_count; ++k)\n"
+            << "            if (m_states.intersects(final_sets[k]))\n"
+            << "                m_visited |= uint64_t{1} << k;\n"
+            << "        if (m_visited == " << to_hex((uint64_t{1} << automaton.m_finals.size()) - 1) << ")\n"
+            << "        {\n            ++m_rounds;\n            m_visited = 0;\n        }\n";
+    }
+    out << "    }\n\n"
+        << "    /// \\brief Current states of all runs\n"
+        << "    [[nodiscard]] constexpr const state_set &states() const { return m_states; }\n\n"
+        << "    /// \\brief Whether the read prefix has a run\n"
+        << "    [[nodiscard]] constexpr bool alive() const { return !m_states.empty(); }\n\n"
+        << "    /// \\brief How many times all final states pluralities were visited by the live runs (generalized Buchi\n"
+        << "    /// rounds). Without final states pluralities each letter read by a run is a round\n"
+        << "    [[nodiscard]] constexpr std::size_t accepting_rounds() const { return m_rounds; }\n\n"
+        << "private:\n"
+        << "    state_set m_states{initial_states};\n"
+        << "    uint64_t m_visited{0};\n"
+        << "    std::size_t m_rounds{0};\n"
+        << "};\n\n"
+        << "} // namespace " << name << "\n";
+
+    return out.str();
+}
+
+std::string generate_round_trip_test(const std::shared_ptr<ltl::converting>& algo, const std::string &name,
+                                     const std::string &header, std::string *diagnostic)
+{
+    if (!fits_masks(algo, diagnostic))
+        return {};
+
+    std::ostringstream out;
+    out << "// Generated by ltl_converter: checks " << header << " against libLtl.so on random traces\n"
+        << "#include \"" << header << "\"\n\n"
+        << "#include \"ltl/closure.hpp\"\n#include \"utils/reader.hpp\"\n\n"
+        << "#include <iostream>\n#include <iterator>\n#include <random>\n#include <set>\n#include <sstream>\n\n"
+        << "int main()\n{\n"
+        << "    std::istringstream in{\"" << algo->get_ltl_formula()->to_string() << "\"};\n"
+        << "    const auto algo = ltl::converting::construct(reader::read_formula(in));\n"
+        << "    const auto [states, ap, table, initials, final_sets] = algo->get_automaton_representation();\n\n"
+        << "    auto to_valuation = [](const ltl::converting::alphabet_t &alph) -> uint64_t\n    {\n"
+        << "        uint64_t valuation = 0;\n"
+        << "        for (std::size_t j = 0; j < " << name << "::propositions.size(); ++j)\n"
+        << "            if (alph.contains(" << name << "::propositions[j]))\n"
+        << "                valuation |= uint64_t{1} << j;\n"
+        << "        return valuation;\n    };\n\n"
+        << "    std::mt19937_64 random{42};\n"
+        << "    std::size_t failures = 0;\n"
+        << "    for (std::size_t trace = 0; trace < 1000; ++trace)\n    {\n"
+        << "        " << name << "::monitor monitor{};\n"
+        << "        std::set<std::size_t> current{initials.begin(), initials.end()};\n"
+        << "        uint64_t visited = 0;\n"
+        << "        std::size_t rounds = 0;\n"
+        << "        for (std::size_t i = 0; i < 64 && failures == 0; ++i)\n        {\n"
+        << "            for (std::size_t j = 0; j < " << name << "::states_count; ++j)\n"
+        << "                if (monitor.states().contains(j) != current.contains(" << name << "::atoms[j]))\n"
+        << "                    ++failures;\n"
+        << "            if (monitor.accepting_rounds() != rounds)\n                ++failures;\n\n"
+        << "            // mostly follow the letters of the current states to keep the trace alive\n"
+        << "            uint64_t valuation = random();\n"
+        << "            if (!current.empty() && random() % 4 != 0)\n            {\n"
+        << "                auto it = current.begin();\n"
+        << "                std::advance(it, static_cast<std::ptrdiff_t>(random() % current.size()));\n"
+        << "                if (const auto transition = table.find(*it); transition != table.end())\n"
+        << "                    valuation = to_valuation(transition->second.first);\n            }\n\n"
+        << "            std::set<std::size_t> next{};\n"
+        << "            for (const auto s : current)\n"
+        << "                if (const auto transition = table.find(s); transition != table.end() &&\n"
+        << "                    to_valuation(transition->second.first) == (valuation & ((uint64_t{1} << "
+        << name << "::propositions.size()) - 1)))\n"
+        << "                    next.insert(transition->second.second.begin(), transition->second.second.end());\n"
+        << "            current = std::move(next);\n"
+        << "            monitor.step(valuation);\n"
+        << "            if (current.empty())\n                continue;\n\n"
+        << "            for (const auto &[k, value] : final_sets)\n"
+        << "                for (const auto s : current)\n"
+        << "                    if (value.contains(s))\n"
+        << "                        visited |= uint64_t{1} << k;\n"
+        << "            if (visited == (uint64_t{1} << " << name << "::final_sets_count) - 1)\n"
+        << "            {\n                ++rounds;\n                visited = 0;\n            }\n"
+        << "        }\n"
+        << "    }\n\n"
+        << "    std::cout << (failures == 0 ? \"OK\" : \"FAILED\") << \"\\n\";\n"
+        << "    return failures == 0 ? 0 : 1;\n"
+        << "}\n";
+
+    return out.str();
+}
+
+} // namespace cpp
@@ -1,5 +1,7 @@
 #include "utils/dot_representation.hpp"
 
+#include <unordered_map>
+
 namespace dot
 {
 
@@ -22,34 +24,153 @@ std::string create_node_style(const std::string &formula, const std::string& fin
             ",label=<" + formula + "<br />" + finals_label_text + ">];";
 }
 
+/// \brief Text of the each closure element (and of its negation): rendered once, referenced by the states.
+/// Element text is composed of the texts of its operands, so each node of the formula is rendered once
+class string_table
+{
+public:
+    explicit string_table(const ltl::converting::state_t &closure)
+    {
+        m_positive.reserve(closure.size());
+        m_negative.reserve(closure.size());
+        for (const auto &node : closure)
+        {
+            const std::string &text = m_positive.emplace_back(render(node));
+            m_negative.emplace_back("! " + text);
+        }
+    }
+
+    /// \note atom element is either the closure element or its negation (closure has no negations)
+    [[nodiscard]] const std::string &get(const ltl::converting::state_t &atom, const size_t i) const
+    {
+        return atom[i]->get_kind() == ltl::ltl::kind::negation ? m_negative[i] : m_positive[i];
+    }
+
+private:
+    const std::string &render(const ltl::ltl::node_t &node)
+    {
+        if (const auto it = m_rendered.find(node.get()); it != m_rendered.end())
+            return it->second;
+
+        auto unary = [this](const char *operation, const ltl::ltl::node_t &operand) -> std::string
+        {
+            return operation + render(operand);
+        };
+        auto binary = [this](const char *operation, const ltl::ltl::node_t &left,
+                             const ltl::ltl::node_t &right) -> std::string
+        {
+            const std::string &left_text = render(left);
+            const std::string &right_text = render(right);
+
+            std::string text;
+            text.reserve(2 + left_text.size() + 1 + right_text.size());
+            text += operation;
+            text += left_text;
+            text += ' ';
+            text += right_text;
+            return text;
+        };
+
+        std::string text;
+        switch (node->get_kind())
+        {
+            case ltl::ltl::kind::negation:
+                text = unary("! ", std::dynamic_pointer_cast<ltl::ltl_negation>(node)->m_negformula);
+                break;
+            case ltl::ltl::kind::conjunction:
+            {
+                const auto &node_conjunction = std::dynamic_pointer_cast<ltl::ltl_conjunction>(node);
+                text = binary("^ ", node_conjunction->m_left, node_conjunction->m_right);
+                break;
+            }
+            case ltl::ltl::kind::next:
+                text = unary("X ", std::dynamic_pointer_cast<ltl::ltl_next>(node)->m_xformula);
+                break;
+            case ltl::ltl::kind::until:
+            {
+                const auto &node_until = std::dynamic_pointer_cast<ltl::ltl_until>(node);
+                text = binary("U ", node_until->m_left, node_until->m_right);
+                break;
+            }
+            case ltl::ltl::kind::disjunction:
+            {
+                const auto &node_disjunction = std::dynamic_pointer_cast<ltl::ltl_disjunction>(node);
+                text = binary("| ", node_disjunction->m_left, node_disjunction->m_right);
+                break;
+            }
+            case ltl::ltl::kind::finally:
+                text = unary("F ", std::dynamic_pointer_cast<ltl::ltl_finally>(node)->m_fformula);
+                break;
+            case ltl::ltl::kind::globally:
+                text = unary("G ", std::dynamic_pointer_cast<ltl::ltl_globally>(node)->m_gformula);
+                break;
+            case ltl::ltl::kind::release:
+            {
+                const auto &node_release = std::dynamic_pointer_cast<ltl::ltl_release>(node);
+                text = binary("R ", node_release->m_left, node_release->m_right);
+                break;
+            }
+            case ltl::ltl::kind::weak_until:
+            {
+                const auto &node_weak_until = std::dynamic_pointer_cast<ltl::ltl_weak_until>(node);
+                text = binary("W ", node_weak_until->m_left, node_weak_until->m_right);
+                break;
+            }
+            default:
+                // constants and propositions
+                node->write(text);
+                break;
+        }
+
+        return m_rendered.emplace(node.get(), std::move(text)).first->second;
+    }
+
+    std::vector<std::string> m_positive{};
+    std::vector<std::string> m_negative{};
+    /// \brief Text of each node of the formula
+    std::unordered_map<const ltl::ltl *, std::string> m_rendered{};
+};
+
 // print all states with its indexes
 std::vector<std::string> generate_states_map(const std::shared_ptr<ltl::converting> &algo,
                                              const ltl::converting::indexes_container_t &states)
 {
-    auto generate_state_full_name = [&algo](const size_t index) -> std::string
+    const string_table table{algo->get_closure()};
+
+    auto generate_state_full_name = [&algo, &table](const size_t index) -> std::string
     {
+        const auto &atom = algo->get_concrete_state(index);
+
+        const std::string prefix = get_node_label_text(index) + " = {";
+        size_t size = prefix.size() + 1;
+        for (size_t i = 0; i < atom.size(); ++i)
+            size += table.get(atom, i).size() + (i == 0 ? 0 : 2);
+
         std::string full_name;
-        for (const auto &node : algo->get_concrete_state(index))
+        full_name.reserve(size);
+        full_name += prefix;
+        for (size_t i = 0; i < atom.size(); ++i)
         {
-            if (!full_name.empty())
+            if (i != 0)
                 full_name += "; ";
-            full_name += node->to_string();
+            full_name += table.get(atom, i);
         }
+        full_name += '}';
 
-        return "{" + full_name + "}";
+        return full_name;
     };
 
     std::vector<std::string> states_map_str;
     states_map_str.reserve(states.size());
     for (const auto index : states)
-        states_map_str.emplace_back(get_node_label_text(index) + " = " + generate_state_full_name(index));
+        states_map_str.emplace_back(generate_state_full_name(index));
 
     return std::move(states_map_str);
 }
 
 std::string generate_nodes(const ltl::converting::indexes_container_t &states,
                            const ltl::converting::indexes_container_t &initials,
-                           const std::map<size_t, ltl::converting::indexes_container_t> &final_sets)
+                           const ltl::converting::finals_t &final_sets)
 {
     std::string nodes;
     for (const auto &index : states)
@@ -79,26 +200,37 @@ std::string generate_nodes(const ltl::converting::indexes_container_t &states,
     return std::move(nodes);
 }
 
-std::string generate_edges(const ltl::converting::table_t &transitions)
+/// \param marks: acceptance sets of the transition-based automaton edge
+template<typename Alphabet>
+std::string create_edge_style(const Alphabet &alph, const std::vector<size_t> &marks = {})
 {
-    std::string edges;
-    for (const auto &[index, value] : transitions)
+    std::string marks_str;
+    for (const auto it : marks)
     {
-        auto create_label = [](const std::set<ltl::ltl_atom::index_atom_t> &alph) -> std::string
-        {
-            const std::string empty_edge_style{"[style=dotted,label=<&#8709;>;];"};
+        if (!marks_str.empty())
+            marks_str += ",";
+        marks_str += std::to_string(it);
+    }
 
-            std::string alph_str;
-            for (const auto it : alph)
-            {
-                if (!alph_str.empty())
-                    alph_str += ",";
-                alph_str += "p" + std::to_string(it);
-            }
+    if (alph.empty())
+        return "[style=dotted,label=<&#8709;" + (marks.empty() ? "" : " F:{" + marks_str + "}") + ">;];";
 
-            return (alph.empty() ? empty_edge_style : ("[label=\"\\{" + alph_str + "\\}\"];"));
-        };
+    std::string alph_str;
+    for (const auto it : alph)
+    {
+        if (!alph_str.empty())
+            alph_str += ",";
+        alph_str += "p" + std::to_string(it);
+    }
 
+    return "[label=\"\\{" + alph_str + "\\}" + (marks.empty() ? "" : " F:\\{" + marks_str + "\\}") + "\"];";
+}
+
+std::string generate_edges(const ltl::converting::table_t &transitions)
+{
+    std::string edges;
+    for (const auto &[index, value] : transitions)
+    {
         std::string next_states_str;
         for (const auto &it : value.second)
         {
@@ -107,7 +239,7 @@ std::string generate_edges(const ltl::converting::table_t &transitions)
             next_states_str += std::to_string(it);
         }
 
-        edges += std::to_string(index) + "->{" + next_states_str + "}" + create_label(value.first);
+        edges += std::to_string(index) + "->{" + next_states_str + "}" + create_edge_style(value.first);
     }
 
     return std::move(edges);
@@ -121,8 +253,9 @@ std::pair<std::vector<std::string>, std::string> convert_to_dot(const std::share
 {
     const auto &[states, _, transitions, initials, final_sets] = algo->get_automaton_representation();
 
-    const std::string header = R"(splines="polyline";rankdir=LR;label=")" + algo->get_ltl_formula()->to_string() +
-                               R"(";labelloc="t";fontsize=30;fontcolor=gray;)";
+    std::string header = R"(splines="polyline";rankdir=LR;label=")";
+    algo->get_ltl_formula()->write(header);
+    header += R"(";labelloc="t";fontsize=30;fontcolor=gray;)";
     const std::string nodes = generate_nodes(states, initials, final_sets);
     const std::string edges = generate_edges(transitions);
 
@@ -132,4 +265,24 @@ std::pair<std::vector<std::string>, std::string> convert_to_dot(const std::share
     };
 }
 
+std::string convert_to_dot(const ltl::tgba &automaton)
+{
+    std::string header = R"(splines="polyline";rankdir=LR;label=")";
+    automaton.get_ltl_formula()->write(header);
+    header += R"( - TGBA";labelloc="t";fontsize=30;fontcolor=gray;)";
+
+    std::string nodes;
+    std::string edges;
+    for (ltl::tgba::state_index_t s = 0; s < automaton.get_states_count(); ++s)
+    {
+        nodes += std::to_string(s) + create_node_style("q" + std::to_string(s), "",
+                                                       s == automaton.get_initial_state());
+        for (const auto &edge : automaton.get_edges(s))
+            edges += std::to_string(s) + "->" + std::to_string(edge.m_target) +
+                     create_edge_style(edge.m_letter, edge.m_marks);
+    }
+
+    return "digraph Automaton {" + header + nodes + edges + "}";
+}
+
 } // namespace dot
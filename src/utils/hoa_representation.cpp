@@ -0,0 +1,138 @@
+#include "utils/hoa_representation.hpp"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace hoa
+{
+
+namespace
+{
+
+/// \brief Header up to the body: states, start states, propositions and acceptance
+std::string generate_header(const ltl::ltl::node_t &formula, const size_t states_count,
+                            const std::vector<size_t> &starts,
+                            const std::vector<ltl::ltl_atom::index_atom_t> &propositions,
+                            const size_t acceptance_sets_count, const bool is_state_based)
+{
+    std::string header = "HOA: v1\nname: \"";
+    formula->write(header);
+    header += "\"\nStates: " + std::to_string(states_count) + "\n";
+    for (const size_t start : starts)
+        header += "Start: " + std::to_string(start) + "\n";
+
+    header += "AP: " + std::to_string(propositions.size());
+    for (const auto it : propositions)
+        header += " \"p" + std::to_string(it) + "\"";
+
+    header += "\nacc-name: generalized-Buchi " + std::to_string(acceptance_sets_count) +
+              "\nAcceptance: " + std::to_string(acceptance_sets_count);
+    for (size_t set = 0; set < acceptance_sets_count; ++set)
+        header += (set == 0 ? " " : "&") + ("Inf(" + std::to_string(set) + ")");
+    if (acceptance_sets_count == 0)
+        header += " t";
+
+    header += "\nproperties: trans-labels explicit-labels ";
+    header += is_state_based ? "state-acc" : "trans-acc";
+    header += "\n--BODY--\n";
+
+    return header;
+}
+
+/// \brief Label of the full valuation: positive propositions of the @letter, the others are negative
+std::string generate_label(const std::vector<ltl::ltl_atom::index_atom_t> &propositions,
+                           const std::vector<ltl::ltl_atom::index_atom_t> &letter)
+{
+    if (propositions.empty())
+        return "[t]";
+
+    std::string label = "[";
+    for (size_t i = 0; i < propositions.size(); ++i)
+    {
+        if (i != 0)
+            label += '&';
+        if (!std::binary_search(letter.begin(), letter.end(), propositions[i]))
+            label += '!';
+        label += std::to_string(i);
+    }
+    label += ']';
+
+    return label;
+}
+
+std::string generate_marks(const std::vector<size_t> &marks)
+{
+    if (marks.empty())
+        return "";
+
+    std::string text = " {";
+    for (size_t i = 0; i < marks.size(); ++i)
+        text += (i == 0 ? "" : " ") + std::to_string(marks[i]);
+    text += '}';
+
+    return text;
+}
+
+} // namespace anonymous
+
+std::string convert_to_hoa(const std::shared_ptr<ltl::converting>& algo)
+{
+    const auto [states, ap, transitions, initials, final_sets] = algo->get_automaton_representation();
+    const std::vector<ltl::ltl_atom::index_atom_t> propositions(ap.begin(), ap.end());
+
+    // HOA states are [0, States): reachable atoms in the ascending order
+    std::map<size_t, size_t> numbers{};
+    for (const size_t index : states)
+        numbers.emplace(index, numbers.size());
+
+    std::vector<size_t> starts{};
+    for (const size_t index : initials)
+        starts.push_back(numbers.at(index));
+
+    const auto &closure = algo->get_closure();
+    const auto acceptance_sets_count = static_cast<size_t>(std::count_if(closure.begin(), closure.end(),
+                                                                         ltl::converting::is_eventuality));
+
+    std::string hoa = generate_header(algo->get_ltl_formula(), numbers.size(), starts, propositions,
+                                      acceptance_sets_count, true);
+    for (const auto &[index, number] : numbers)
+    {
+        std::vector<size_t> marks{};
+        for (const auto &[set, value] : final_sets)
+            if (value.contains(index))
+                marks.push_back(set);
+        hoa += "State: " + std::to_string(number) + generate_marks(marks) + "\n";
+
+        if (const auto it = transitions.find(index); it != transitions.end())
+        {
+            const std::vector<ltl::ltl_atom::index_atom_t> letter(it->second.first.begin(), it->second.first.end());
+            const std::string label = generate_label(propositions, letter);
+            for (const size_t next : it->second.second)
+                hoa += label + " " + std::to_string(numbers.at(next)) + "\n";
+        }
+    }
+    hoa += "--END--\n";
+
+    return hoa;
+}
+
+std::string convert_to_hoa(const ltl::tgba &automaton)
+{
+    const auto &propositions = automaton.get_propositions();
+    std::string hoa = generate_header(automaton.get_ltl_formula(), automaton.get_states_count(),
+                                      {automaton.get_initial_state()}, propositions,
+                                      automaton.get_acceptance_sets_count(), false);
+    for (ltl::tgba::state_index_t s = 0; s < automaton.get_states_count(); ++s)
+    {
+        hoa += "State: " + std::to_string(s) + "\n";
+        for (const auto &edge : automaton.get_edges(s))
+            hoa += generate_label(propositions, edge.m_letter) + " " + std::to_string(edge.m_target) +
+                   generate_marks(edge.m_marks) + "\n";
+    }
+    hoa += "--END--\n";
+
+    return hoa;
+}
+
+} // namespace hoa
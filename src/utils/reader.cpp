@@ -1,42 +1,99 @@
 #include "utils/reader.hpp"
+
 #include <cassert>
+#include <cctype>
+#include <iostream>
+#include <string_view>
 
 namespace reader
 {
 
+namespace
+{
+
+template<typename T>
+ltl::ltl::node_t read_unary(std::istream &in, std::pmr::memory_resource *resource)
+{
+    auto formula = read_formula(in, resource);
+    if (!formula)
+        return nullptr;
+
+    return T::construct(std::move(formula), resource);
+}
+
+/// \brief Read both operands in the input order
+/// \note evaluation order of the function arguments is unspecified, so they can't be read inside the call
+template<typename T>
+ltl::ltl::node_t read_binary(std::istream &in, std::pmr::memory_resource *resource)
+{
+    auto left = read_formula(in, resource);
+    if (!left)
+        return nullptr;
+    auto right = read_formula(in, resource);
+    if (!right)
+        return nullptr;
+
+    return T::construct(std::move(left), std::move(right), resource);
+}
+
+} // namespace anonymous
+
 /// \return	the parsed formula, or NULL on error
-std::shared_ptr<ltl::ltl> read_formula()
+std::shared_ptr<ltl::ltl> read_formula(std::istream &in, std::pmr::memory_resource *resource)
 {
     int ch;
-    while ((ch = getchar()) == ' ' || ch == '\n' || ch == '\r' || ch == '\t' || ch == '\v' || ch == '\f');
+    while (std::isspace(ch = in.get()));
     switch (ch)
     {
         case 't':
-            return ltl::ltl_one::construct();
+            // "true" is accepted as well: it's the text representation of the constant
+            if (in.peek() == 'r')
+            {
+                for (const char expected : std::string_view{"rue"})
+                    if (in.get() != expected)
+                        return nullptr;
+            }
+            return ltl::ltl_one::construct(resource);
         case 'p':
+        {
+            if (!std::isdigit(in.peek()))
+                return nullptr;
             ltl::ltl_atom::index_atom_t index;
-            // TODO: find another approach
-            if (scanf("%u", &index) == 1)
-                return ltl::ltl_atom::construct(index);
-            assert(!"Error in proposition number");
+            if (in >> index)
+                return ltl::ltl_atom::construct(index, resource);
+            // Error in proposition number
             return nullptr;
+        }
         case '!':
-            return ltl::ltl_negation::construct(read_formula());
+            return read_unary<ltl::ltl_negation>(in, resource);
         case '^':
-            return ltl::ltl_conjunction::construct(read_formula(), read_formula());
+            return read_binary<ltl::ltl_conjunction>(in, resource);
+        case '|':
+            return read_binary<ltl::ltl_disjunction>(in, resource);
         case 'X':
-            return ltl::ltl_next::construct(read_formula());
+            return read_unary<ltl::ltl_next>(in, resource);
+        case 'F':
+            return read_unary<ltl::ltl_finally>(in, resource);
+        case 'G':
+            return read_unary<ltl::ltl_globally>(in, resource);
         case 'U':
-            return ltl::ltl_until::construct(read_formula(), read_formula());
-        case EOF:
-            assert(!"ERROR: unexpected end of file while parsing formula");
-            return nullptr;
+            return read_binary<ltl::ltl_until>(in, resource);
+        case 'R':
+            return read_binary<ltl::ltl_release>(in, resource);
+        case 'W':
+            return read_binary<ltl::ltl_weak_until>(in, resource);
         default:
-            assert(!"unknown character" && static_cast<char>(ch));
+            // unexpected end of file or unknown character
             return nullptr;
     }
+}
 
-    return nullptr;
+/// \return	the parsed formula, or NULL on error
+std::shared_ptr<ltl::ltl> read_formula()
+{
+    auto formula = read_formula(std::cin);
+    assert(formula && "ERROR: incorrect LTL-formula on the standard input");
+    return formula;
 }
 
 } // namespace reader
@@ -0,0 +1,354 @@
+#include "utils/server.hpp"
+#include "utils/dot_representation.hpp"
+#include "utils/hoa_representation.hpp"
+#include "utils/reader.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <new>
+#include <sstream>
+#include <system_error>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace server
+{
+
+namespace
+{
+
+constexpr size_t latencies_capacity = 4096;
+/// \brief Longer requests are rejected: a client can't make the server buffer an endless line
+constexpr size_t max_request_size = 64 * 1024;
+/// \brief Pause of @service::listen when descriptors or memory are exhausted, until connections release them
+constexpr std::chrono::milliseconds accept_backoff{100};
+
+std::string frame(const std::pair<std::string, bool> &response)
+{
+    const auto &[payload, success] = response;
+    return (success ? "ok " : "error ") + std::to_string(payload.size()) + "\n" + payload;
+}
+
+/// \note MSG_NOSIGNAL: a client that closed its socket is a disconnect (EPIPE), not a SIGPIPE for the process
+/// \return false if the client disconnected
+bool write_all(const int fd, const std::string &data)
+{
+    size_t written = 0;
+    while (written < data.size())
+    {
+        const ssize_t n = ::send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        written += static_cast<size_t>(n);
+    }
+
+    return true;
+}
+
+} // namespace anonymous
+
+service::service(const size_t cache_capacity, const size_t max_connections)
+        : m_cache_capacity(std::max<size_t>(cache_capacity, 1)),
+          m_max_connections(std::max<size_t>(max_connections, 1)),
+          m_shapes({}, m_cache_capacity)
+{
+    m_latencies.reserve(latencies_capacity);
+}
+
+std::string service::handle(const std::string &request)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::pair<std::string, bool> result{};
+    try
+    {
+        result = execute(request);
+    }
+    catch (const std::bad_alloc &)
+    {
+        result = {"out of memory\n", false};
+    }
+    catch (const std::exception &error)
+    {
+        result = {std::string{"internal error: "} + error.what() + "\n", false};
+    }
+    catch (...)
+    {
+        result = {"internal error\n", false};
+    }
+    std::string response = frame(result);
+    record_latency(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+
+    return response;
+}
+
+void service::run(std::istream &in, std::ostream &out)
+{
+    for (std::string line; std::getline(in, line);)
+    {
+        if (line.empty())
+            continue;
+        out << handle(line) << std::flush;
+    }
+}
+
+bool service::listen(const std::string &socket_path)
+{
+    sockaddr_un address{};
+    if (socket_path.size() >= sizeof(address.sun_path))
+        return false;
+
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+        return false;
+
+    address.sun_family = AF_UNIX;
+    std::copy(socket_path.begin(), socket_path.end(), address.sun_path);
+    ::unlink(socket_path.c_str());
+    if (::bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0 ||
+        ::listen(listener, SOMAXCONN) < 0)
+    {
+        ::close(listener);
+        return false;
+    }
+
+    while (true)
+    {
+        const int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+            {
+                std::this_thread::sleep_for(accept_backoff);
+                continue;
+            }
+
+            ::close(listener);
+            return false;
+        }
+
+        if (m_connections.fetch_add(1) >= m_max_connections)
+        {
+            --m_connections;
+            write_all(fd, frame({"too many connections\n", false}));
+            ::close(fd);
+            continue;
+        }
+
+        try
+        {
+            std::thread{[this, fd]()
+                        {
+                            serve_connection(fd);
+                            --m_connections;
+                        }}.detach();
+        }
+        catch (const std::system_error &)
+        {
+            --m_connections;
+            ::close(fd);
+        }
+    }
+}
+
+std::string service::get_statistics() const
+{
+    std::vector<std::chrono::microseconds> latencies;
+    size_t requests;
+    {
+        std::lock_guard lock{m_latency_mutex};
+        latencies = m_latencies;
+        requests = m_requests;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&latencies](const size_t p) -> long long
+    {
+        if (latencies.empty())
+            return 0;
+        return latencies[(latencies.size() - 1) * p / 100].count();
+    };
+
+    const size_t hits = m_hits;
+    const size_t misses = m_misses;
+    size_t cached;
+    {
+        std::lock_guard lock{m_cache_mutex};
+        cached = m_cache.size();
+    }
+
+    const auto shapes = m_shapes.get_statistics();
+
+    std::ostringstream out;
+    out << "requests " << requests << "\n"
+        << "latency_us p50 " << percentile(50) << " p90 " << percentile(90) << " p99 " << percentile(99)
+        << " max " << (latencies.empty() ? 0 : latencies.back().count()) << "\n"
+        << "cache hits " << hits << " misses " << misses << " hit_rate "
+        << (hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses)) << "\n"
+        << "cache size " << cached << " capacity " << m_cache_capacity << "\n"
+        << "shapes hits " << shapes.m_memory_hits << " misses " << shapes.m_misses << "\n";
+
+    return out.str();
+}
+
+std::pair<std::string, bool> service::execute(const std::string &request)
+{
+    if (request.size() > max_request_size)
+        return {"request is too long\n", false};
+
+    std::istringstream in{request};
+    std::string command;
+    in >> command;
+
+    if (command == "stats")
+        return {get_statistics(), true};
+    if (command != "dot" && command != "states" && command != "tgba" && command != "hoa")
+        return {"unknown command: " + command + "\n", false};
+
+    const auto formula = reader::read_formula(in);
+    if (!formula)
+        return {"incorrect LTL-formula\n", false};
+    // only spaces can follow the formula
+    for (int ch; (ch = in.get()) != std::char_traits<char>::eof();)
+        if (!std::isspace(ch))
+            return {"incorrect LTL-formula\n", false};
+
+    // identical formulas have the same representation, whatever the spacing of the request was
+    const std::string key = formula->to_string();
+    auto cached = find(key);
+    if (cached)
+    {
+        ++m_hits;
+    }
+    else
+    {
+        ++m_misses;
+
+        auto value = std::make_shared<entry>();
+        value->m_algo = m_shapes.convert(ltl::ltl::node_t{formula});
+        auto [states, dot] = dot::convert_to_dot(value->m_algo);
+        value->m_dot = std::move(dot);
+        for (const auto &it : states)
+            value->m_states += it + "\n";
+
+        cached = value;
+        insert(key, std::move(value));
+    }
+
+    if (command == "tgba" || command == "hoa")
+    {
+        // if the construction throws, the flag stays unset and the next request of the formula retries it
+        std::call_once(cached->m_tgba_once, [&value = *cached]()
+        {
+            const auto automaton = ltl::tgba::construct(*value.m_algo);
+            value.m_tgba_dot = dot::convert_to_dot(*automaton);
+            value.m_hoa = hoa::convert_to_hoa(*automaton);
+        });
+        return {command == "tgba" ? cached->m_tgba_dot : cached->m_hoa, true};
+    }
+    return {command == "dot" ? cached->m_dot : cached->m_states, true};
+}
+
+std::shared_ptr<const service::entry> service::find(const std::string &key)
+{
+    std::lock_guard lock{m_cache_mutex};
+    const auto it = m_cache.find(key);
+    if (it == m_cache.end())
+        return nullptr;
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->second;
+}
+
+void service::insert(const std::string &key, std::shared_ptr<const entry> value)
+{
+    std::lock_guard lock{m_cache_mutex};
+    if (const auto it = m_cache.find(key); it != m_cache.end())
+    {
+        // converted concurrently by another request
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return;
+    }
+
+    m_lru.emplace_front(key, std::move(value));
+    m_cache[key] = m_lru.begin();
+    if (m_lru.size() > m_cache_capacity)
+    {
+        m_cache.erase(m_lru.back().first);
+        m_lru.pop_back();
+    }
+}
+
+void service::record_latency(const std::chrono::microseconds latency)
+{
+    std::lock_guard lock{m_latency_mutex};
+    ++m_requests;
+    if (m_latencies.size() < latencies_capacity)
+    {
+        m_latencies.push_back(latency);
+        return;
+    }
+
+    m_latencies[m_latencies_next] = latency;
+    m_latencies_next = (m_latencies_next + 1) % latencies_capacity;
+}
+
+void service::serve_connection(const int fd)
+{
+    std::string buffer;
+    bool skip_line = false;
+    char chunk[4096];
+    while (true)
+    {
+        const ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        buffer.append(chunk, static_cast<size_t>(n));
+
+        if (skip_line)
+        {
+            const size_t end = buffer.find('\n');
+            if (end == std::string::npos)
+            {
+                buffer.clear();
+                continue;
+            }
+            buffer.erase(0, end + 1);
+            skip_line = false;
+        }
+
+        size_t begin = 0;
+        for (size_t end; (end = buffer.find('\n', begin)) != std::string::npos; begin = end + 1)
+        {
+            const std::string line = buffer.substr(begin, end - begin);
+            if (!line.empty() && !write_all(fd, handle(line)))
+            {
+                ::close(fd);
+                return;
+            }
+        }
+        buffer.erase(0, begin);
+
+        // the line is already too long: it's rejected and the rest of it is skipped
+        if (buffer.size() > max_request_size)
+        {
+            if (!write_all(fd, handle(buffer)))
+                break;
+            buffer.clear();
+            skip_line = true;
+        }
+    }
+
+    ::close(fd);
+}
+
+} // namespace server
@@ -0,0 +1,180 @@
+// Regression checks of the acceptance: negated Globally, Release and Weak Until are eventualities,
+// so their automata reject the words that never fulfil them
+#include "ltl/closure.hpp"
+#include "ltl/static_automaton.hpp"
+#include "ltl/tgba.hpp"
+#include "utils/reader.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+namespace ct = ltl::compile_time;
+
+// ! G p0
+using not_globally = ct::automaton<ct::negation<ct::globally<ct::atom<0>>>>;
+// ! R p0 p1
+using not_release = ct::automaton<ct::negation<ct::release<ct::atom<0>, ct::atom<1>>>>;
+// ! W p0 p1
+using not_weak_until = ct::automaton<ct::negation<ct::weak_until<ct::atom<0>, ct::atom<1>>>>;
+
+static_assert(not_globally::finals_count == 1);
+static_assert(not_release::finals_count == 1);
+static_assert(not_weak_until::finals_count == 1);
+
+using letter_t = std::set<ltl::ltl_atom::index_atom_t>;
+
+std::shared_ptr<ltl::converting> convert(const std::string &formula)
+{
+    std::istringstream in{formula};
+    return ltl::converting::construct(reader::read_formula(in));
+}
+
+/// \brief Whether the automaton accepts the infinite repetition of @loop
+bool accepts(const ltl::converting &algo, const std::vector<letter_t> &loop)
+{
+    const auto [states, ap, table, initials, final_sets] = algo.get_automaton_representation();
+    const auto &closure = algo.get_closure();
+    const auto eventualities = static_cast<size_t>(std::count_if(closure.begin(), closure.end(),
+                                                                 ltl::converting::is_eventuality));
+
+    // product of the automaton and the word: node is (state, position in the loop)
+    using node_t = std::pair<size_t, size_t>;
+    auto successors = [&](const node_t &node) -> std::vector<node_t>
+    {
+        std::vector<node_t> result{};
+        const auto transition = table.find(node.first);
+        if (transition == table.end() ||
+            letter_t(transition->second.first.begin(), transition->second.first.end()) != loop[node.second])
+        {
+            return result;
+        }
+        for (const size_t next : transition->second.second)
+            result.emplace_back(next, (node.second + 1) % loop.size());
+        return result;
+    };
+    auto reach = [&](std::vector<node_t> queue) -> std::set<node_t>
+    {
+        std::set<node_t> visited{};
+        while (!queue.empty())
+        {
+            const node_t node = queue.back();
+            queue.pop_back();
+            for (const auto &next : successors(node))
+                if (visited.insert(next).second)
+                    queue.push_back(next);
+        }
+        return visited;
+    };
+
+    std::vector<node_t> initial{};
+    for (const size_t s : initials)
+        initial.emplace_back(s, 0);
+    std::set<node_t> reachable = reach(initial);
+    reachable.insert(initial.begin(), initial.end());
+
+    // accepting cycle: the component of a reachable node visits each final states plurality
+    for (const auto &node : reachable)
+    {
+        const auto forward = reach({node});
+        if (!forward.contains(node))
+            continue;
+
+        std::set<size_t> component{};
+        for (const auto &other : forward)
+            if (reach({other}).contains(node))
+                component.insert(other.first);
+
+        // an eventuality without final states is never fulfilled
+        bool accepting = true;
+        for (size_t set = 0; set < eventualities; ++set)
+        {
+            const auto finals = final_sets.find(set);
+            accepting = accepting && finals != final_sets.end() &&
+                        std::any_of(component.begin(), component.end(),
+                                    [&finals](const size_t s) -> bool { return finals->second.contains(s); });
+        }
+        if (accepting)
+            return true;
+    }
+
+    return false;
+}
+
+/// \brief Final states of the compile-time automaton are the same as of the runtime one
+template<typename Automaton>
+bool same_finals(const ltl::converting &algo)
+{
+    const auto [states, ap, table, initials, final_sets] = algo.get_automaton_representation();
+    if (final_sets.size() != Automaton::finals_count)
+        return false;
+
+    for (const auto &[set, finals] : final_sets)
+        for (size_t s = 0; s < Automaton::atoms_count; ++s)
+            if (Automaton::is_final(set, s) != finals.contains(s))
+                return false;
+
+    return true;
+}
+
+} // namespace anonymous
+
+int main()
+{
+    struct check
+    {
+        std::string m_formula;
+        std::vector<letter_t> m_loop;
+        bool m_accepted;
+    };
+    const std::vector<check> checks{
+            {"! G p0", {{0}}, false},
+            {"! G p0", {{0}, {}}, true},
+            {"G p0", {{0}}, true},
+            {"! R p0 p1", {{1}}, false},
+            {"! R p0 p1", {{}}, true},
+            {"R p0 p1", {{1}}, true},
+            {"! W p0 p1", {{0}}, false},
+            {"! W p0 p1", {{0}, {}}, true},
+            {"W p0 p1", {{0}}, true},
+            {"U p0 p1", {{0}}, false},
+            {"F p0", {{}, {0}}, true},
+    };
+
+    size_t failures = 0;
+    for (const auto &[formula, loop, accepted] : checks)
+    {
+        const auto algo = convert(formula);
+        if (accepts(*algo, loop) != accepted)
+        {
+            std::cerr << formula << ": the loop of " << loop.size() << " letters should be "
+                      << (accepted ? "accepted" : "rejected") << "\n";
+            ++failures;
+        }
+    }
+
+    for (const std::string formula : {"! G p0", "! R p0 p1", "! W p0 p1"})
+    {
+        if (ltl::tgba::construct(*convert(formula))->get_acceptance_sets_count() != 1)
+        {
+            std::cerr << formula << ": TGBA should have one acceptance set\n";
+            ++failures;
+        }
+    }
+
+    if (!same_finals<not_globally>(*convert("! G p0")) || !same_finals<not_release>(*convert("! R p0 p1")) ||
+        !same_finals<not_weak_until>(*convert("! W p0 p1")))
+    {
+        std::cerr << "Final states of the compile-time automata differ\n";
+        ++failures;
+    }
+
+    std::cout << (failures == 0 ? "OK" : "FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
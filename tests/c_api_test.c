@@ -0,0 +1,248 @@
+/* C99 checks of the C interface: parsing, conversion, cancellation, sharing a context between the threads
+ * and the size convention of the list queries */
+/* nanosleep */
+#define _POSIX_C_SOURCE 200809L
+
+#include "ltl/c_api.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);     \
+            ++failures;                                                         \
+        }                                                                       \
+    } while (0)
+
+static ltl_formula* parse(ltl_context *context, const char *text)
+{
+    ltl_formula *formula = NULL;
+    CHECK(ltl_parse(context, text, strlen(text), &formula) == LTL_OK);
+    return formula;
+}
+
+static void sleep_milliseconds(const long milliseconds)
+{
+    struct timespec duration;
+    duration.tv_sec = milliseconds / 1000;
+    duration.tv_nsec = (milliseconds % 1000) * 1000000L;
+    nanosleep(&duration, NULL);
+}
+
+static void check_parse(ltl_context *context)
+{
+    ltl_formula *formula = NULL;
+    CHECK(ltl_parse(context, "U p0 p1 p2", 10, &formula) == LTL_ERROR_PARSE);
+    CHECK(ltl_parse(context, "U p0", 4, &formula) == LTL_ERROR_PARSE);
+    CHECK(ltl_parse(context, "U p0 p1 \n", 9, &formula) == LTL_OK);
+    CHECK(ltl_parse(NULL, "p0", 2, &formula) == LTL_ERROR_ARGUMENT);
+    ltl_formula_destroy(formula);
+
+    /* only the @size bytes are parsed */
+    formula = NULL;
+    CHECK(ltl_parse(context, "X p0 garbage", 4, &formula) == LTL_OK);
+
+    char text[64];
+    const size_t length = ltl_formula_to_string(formula, NULL, 0);
+    CHECK(length > 0 && length < sizeof(text));
+    CHECK(ltl_formula_to_string(formula, text, sizeof(text)) == length && strlen(text) == length);
+
+    char prefix[4] = {'x', 'x', 'x', 'x'};
+    CHECK(ltl_formula_to_string(formula, prefix, 3) == length);
+    CHECK(prefix[2] == '\0' && strncmp(prefix, text, 2) == 0 && prefix[3] == 'x');
+    ltl_formula_destroy(formula);
+
+    CHECK(strcmp(ltl_status_string(LTL_ERROR_INTERNAL), "unknown status") != 0);
+}
+
+static void check_queries(const ltl_automaton *automaton)
+{
+    const size_t sentinel = (size_t)-1;
+    size_t states[2] = {sentinel, sentinel};
+
+    const size_t states_count = ltl_automaton_states(automaton, NULL, 0);
+    CHECK(states_count > 1);
+    CHECK(ltl_automaton_states(automaton, states, 1) == states_count && states[1] == sentinel);
+
+    const size_t initial_count = ltl_automaton_initial_states(automaton, NULL, 0);
+    CHECK(initial_count > 0);
+    states[0] = sentinel;
+    CHECK(ltl_automaton_initial_states(automaton, states, 1) == initial_count && states[0] < sentinel &&
+          states[1] == sentinel);
+
+    const size_t initial = states[0];
+    const size_t next_count = ltl_automaton_next_states(automaton, initial, NULL, 0);
+    CHECK(next_count > 0);
+    states[0] = sentinel;
+    CHECK(ltl_automaton_next_states(automaton, initial, states, 1) == next_count && states[1] == sentinel);
+
+    uint32_t propositions[1] = {0};
+    CHECK(ltl_automaton_propositions(automaton, NULL, 0) == 2);
+    CHECK(ltl_automaton_propositions(automaton, propositions, 1) == 2 && propositions[0] == 0);
+
+    const size_t closure_size = ltl_automaton_closure_size(automaton);
+    uint8_t signs[1] = {2};
+    CHECK(ltl_automaton_atom(automaton, initial, NULL, 0) == closure_size);
+    CHECK(ltl_automaton_atom(automaton, initial, signs, 1) == closure_size && signs[0] <= 1);
+    CHECK(ltl_automaton_atom(automaton, ltl_automaton_atoms_count(automaton), signs, 1) == 0);
+
+    char element[2] = {'x', 'x'};
+    const size_t element_length = ltl_automaton_closure_element(automaton, closure_size - 1, NULL, 0);
+    CHECK(element_length > 1);
+    CHECK(ltl_automaton_closure_element(automaton, closure_size - 1, element, 1) == element_length &&
+          element[0] == '\0' && element[1] == 'x');
+
+    const size_t sets = ltl_automaton_final_sets_count(automaton);
+    CHECK(sets > 0);
+    CHECK(ltl_automaton_final_states(automaton, sets, states, 2) == 0);
+}
+
+static void check_convert(ltl_context *context)
+{
+    ltl_formula *formula = parse(context, "^ U p0 p1 G F p1");
+    ltl_automaton *automaton = NULL;
+    CHECK(ltl_convert(context, formula, NULL, &automaton) == LTL_OK);
+    check_queries(automaton);
+
+    ltl_options options;
+    options.size = sizeof(options);
+    options.flags = LTL_OPTION_COMPOSE;
+    ltl_automaton *composed = NULL;
+    CHECK(ltl_convert(context, formula, &options, &composed) == LTL_OK);
+    check_queries(composed);
+    CHECK(ltl_automaton_final_sets_count(composed) == ltl_automaton_final_sets_count(automaton));
+
+    ltl_tgba *tgba = NULL;
+    CHECK(ltl_automaton_to_tgba(automaton, &tgba) == LTL_OK);
+    CHECK(ltl_tgba_acceptance_sets_count(tgba) == ltl_automaton_final_sets_count(automaton));
+    CHECK(ltl_tgba_edges_count(tgba, ltl_tgba_initial_state(tgba)) > 0);
+    CHECK(ltl_automaton_to_tgba(NULL, &tgba) == LTL_ERROR_ARGUMENT);
+
+    CHECK(ltl_convert(context, NULL, NULL, &automaton) == LTL_ERROR_ARGUMENT);
+
+    ltl_tgba_destroy(tgba);
+    ltl_automaton_destroy(composed);
+    ltl_automaton_destroy(automaton);
+    ltl_formula_destroy(formula);
+}
+
+struct conversion
+{
+    ltl_context *m_context;
+    const char *m_text;
+    ltl_status m_status;
+    size_t m_atoms;
+};
+
+static void* convert(void *argument)
+{
+    struct conversion *job = argument;
+    ltl_formula *formula = NULL;
+    ltl_automaton *automaton = NULL;
+    job->m_status = ltl_parse(job->m_context, job->m_text, strlen(job->m_text), &formula);
+    if (job->m_status == LTL_OK)
+        job->m_status = ltl_convert(job->m_context, formula, NULL, &automaton);
+    job->m_atoms = ltl_automaton_atoms_count(automaton);
+
+    ltl_automaton_destroy(automaton);
+    ltl_formula_destroy(formula);
+    return NULL;
+}
+
+static void check_threads(ltl_context *context)
+{
+    struct conversion jobs[2] = {{context, "U p0 p1", LTL_OK, 0}, {context, "G F p0", LTL_OK, 0}};
+    size_t expected[2];
+    for (size_t i = 0; i < 2; ++i)
+    {
+        convert(&jobs[i]);
+        expected[i] = jobs[i].m_atoms;
+    }
+
+    pthread_t threads[2];
+    for (size_t i = 0; i < 2; ++i)
+        CHECK(pthread_create(&threads[i], NULL, convert, &jobs[i]) == 0);
+    for (size_t i = 0; i < 2; ++i)
+    {
+        pthread_join(threads[i], NULL);
+        CHECK(jobs[i].m_status == LTL_OK && jobs[i].m_atoms == expected[i] && expected[i] > 0);
+    }
+}
+
+struct cancellation
+{
+    struct conversion m_job;
+    pthread_mutex_t m_mutex;
+    int m_done;
+};
+
+static void* convert_and_finish(void *argument)
+{
+    struct cancellation *state = argument;
+    convert(&state->m_job);
+
+    pthread_mutex_lock(&state->m_mutex);
+    state->m_done = 1;
+    pthread_mutex_unlock(&state->m_mutex);
+    return NULL;
+}
+
+static void check_cancel(ltl_context *context)
+{
+    /* cancellation doesn't affect the next conversions */
+    ltl_context_cancel(context);
+    ltl_formula *formula = parse(context, "F p0");
+    ltl_automaton *automaton = NULL;
+    CHECK(ltl_convert(context, formula, NULL, &automaton) == LTL_OK);
+    ltl_automaton_destroy(automaton);
+    ltl_formula_destroy(formula);
+
+    /* 3^10 atoms take long to connect, unless it is cancelled. Cancel is repeated because the conversion
+     * that hasn't started yet isn't affected */
+    struct cancellation state;
+    state.m_job.m_context = context;
+    state.m_job.m_text = "^ F p0 ^ F p1 ^ F p2 ^ F p3 ^ F p4 ^ F p5 ^ F p6 ^ F p7 ^ F p8 F p9";
+    state.m_job.m_status = LTL_OK;
+    state.m_job.m_atoms = 0;
+    pthread_mutex_init(&state.m_mutex, NULL);
+    state.m_done = 0;
+
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, convert_and_finish, &state) == 0);
+    for (int done = 0; !done;)
+    {
+        sleep_milliseconds(50);
+        ltl_context_cancel(context);
+        pthread_mutex_lock(&state.m_mutex);
+        done = state.m_done;
+        pthread_mutex_unlock(&state.m_mutex);
+    }
+    pthread_join(thread, NULL);
+    pthread_mutex_destroy(&state.m_mutex);
+
+    CHECK(state.m_job.m_status == LTL_ERROR_CANCELLED && state.m_job.m_atoms == 0);
+}
+
+int main(void)
+{
+    ltl_context *context = ltl_context_create();
+    CHECK(context != NULL);
+
+    check_parse(context);
+    check_convert(context);
+    check_threads(context);
+    check_cancel(context);
+
+    ltl_context_destroy(context);
+
+    printf("%s\n", failures == 0 ? "OK" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}